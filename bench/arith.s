@@ -0,0 +1,24 @@
+# file: arith.s
+# tight register-only loop, 8 instructions per iteration
+
+.global start
+
+.section code
+start:
+    ld $10000000, %r1
+    ld $1, %r2
+    ld $3, %r4
+    ld $0x5bd1e995, %r5
+    ld $0, %r3
+loop:
+    add %r2, %r3
+    mul %r4, %r3
+    xor %r5, %r3
+    shl %r2, %r3
+    shr %r2, %r3
+    or %r2, %r6
+    sub %r2, %r1
+    bne %r1, %r0, loop
+    halt
+
+.end
@@ -0,0 +1,34 @@
+# file: interrupts.s
+# software interrupt on every iteration, the handler counts them
+
+.global start
+
+.section code
+start:
+    ld $0xFFFFFE00, %sp
+    ld $handler, %r1
+    csrwr %r1, %handler
+    ld $2000000, %r4
+    ld $1, %r3
+loop:
+    int
+    sub %r3, %r4
+    bne %r4, %r0, loop
+    ld count, %r1
+    halt
+
+handler:
+    push %r1
+    push %r2
+    csrrd %cause, %r1
+    ld count, %r2
+    add %r3, %r2
+    st %r2, count
+    pop %r2
+    pop %r1
+    iret
+
+count:
+.word 0
+
+.end
@@ -0,0 +1,30 @@
+# file: literals.s
+# constants that don't fit an instruction, every one is a literal pool load
+
+.global start
+
+.section code
+start:
+    ld $0xFFFFFE00, %sp
+    ld $2000000, %r1
+    ld $1, %r9
+loop:
+    ld $0x12345678, %r2
+    push %r2
+    ld $0x9abcdef0, %r3
+    push %r3
+    ld $0x0badf00d, %r5
+    xor %r5, %r2
+    ld $0x7fffffff, %r6
+    and %r6, %r3
+    pop %r3
+    pop %r2
+    ld $0xdeadbeef, %r7
+    add %r7, %r8
+    ld $0x40000000, %r10
+    or %r10, %r8
+    sub %r9, %r1
+    bne %r1, %r0, loop
+    halt
+
+.end
@@ -0,0 +1,31 @@
+# file: memcpy.s
+# copies a 16 KiB buffer word by word, 2000 times
+
+.global start
+
+.section code
+start:
+    ld $0x10000, %r1
+    ld $0x14000, %r3
+    ld $4, %r6
+fill:
+    st %r1, [%r1]
+    add %r6, %r1
+    bne %r1, %r3, fill
+
+    ld $2000, %r7
+    ld $1, %r8
+copy:
+    ld $0x10000, %r1
+    ld $0x20000, %r2
+word:
+    ld [%r1], %r5
+    st %r5, [%r2]
+    add %r6, %r1
+    add %r6, %r2
+    bne %r1, %r3, word
+    sub %r8, %r7
+    bne %r7, %r0, copy
+    halt
+
+.end
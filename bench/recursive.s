@@ -0,0 +1,40 @@
+# file: recursive.s
+# naive recursive fibonacci, every call goes through the stack
+
+.global start
+
+.section code
+start:
+    ld $0xFFFFFE00, %sp
+    ld $27, %r1
+    call fib
+    st %r2, result
+    halt
+
+# r2 = fib(r1), r1 is preserved, r3 is scratch
+fib:
+    ld $2, %r3
+    bgt %r3, %r1, small
+    push %r1
+    ld $1, %r3
+    sub %r3, %r1
+    call fib
+    pop %r1
+    push %r1
+    push %r2
+    ld $2, %r3
+    sub %r3, %r1
+    call fib
+    pop %r3
+    add %r3, %r2
+    pop %r1
+    ret
+small:
+    ld $0, %r2
+    add %r1, %r2
+    ret
+
+result:
+.word 0
+
+.end
@@ -0,0 +1,73 @@
+#!/bin/sh
+# Assembles, links and runs every guest kernel in bench/, in the interpreter and with the JIT,
+# and writes the emulator's --stats numbers to bench/results.json (or $BENCH_OUTPUT).
+# Run from the repository root after building asembler, linker and emulator, "make bench" does both.
+
+KERNELS="arith memcpy recursive interrupts literals"
+BUILD=bench/build
+OUTPUT=${BENCH_OUTPUT:-bench/results.json}
+
+mkdir -p $BUILD
+
+# value of the first "<label>: <value>" line of a --stats output
+stat() {
+  awk -v label="$1" 'index($0, label ": ") == 1 { print $(split(label, words, " ") + 1); exit }' "$2"
+}
+
+commit=$(git rev-parse --short HEAD 2>/dev/null || echo unknown)
+{
+  echo "{"
+  echo "  \"commit\": \"$commit\","
+  echo "  \"date\": \"$(date -u +%Y-%m-%dT%H:%M:%SZ)\","
+  echo "  \"results\": ["
+} > $OUTPUT
+
+printf "%-12s %-12s %14s %10s %10s %12s %12s\n" kernel mode instructions MIPS ns/instr "RSS KiB" "startup us"
+first=1
+for kernel in $KERNELS; do
+  rm -f $BUILD/$kernel.o $BUILD/$kernel.lnk
+  ./asembler -o $BUILD/$kernel.o bench/$kernel.s > /dev/null
+  if [ ! -f $BUILD/$kernel.o ]; then echo "could not assemble bench/$kernel.s"; exit 1; fi
+  ./linker -hex -place=code@0x40000000 -o $BUILD/$kernel.hex $BUILD/$kernel.o > /dev/null
+  if [ ! -f $BUILD/$kernel.lnk ]; then echo "could not link $BUILD/$kernel.o"; exit 1; fi
+
+  for mode in interpreter jit; do
+    flags="--stats"
+    if [ $mode = jit ]; then flags="--stats --jit"; fi
+    # the emulator leaves mem_content.hex in the working directory
+    (cd $BUILD && ../../emulator $kernel.lnk $flags > $kernel.$mode.txt)
+    if [ $? -ne 0 ]; then echo "$kernel did not halt in $mode mode"; exit 1; fi
+
+    stats=$BUILD/$kernel.$mode.txt
+    instructions=$(stat "Instructions retired" $stats)
+    execution=$(stat "Execution time" $stats)
+    startup=$(stat "Startup time" $stats)
+    rss=$(stat "Peak RSS" $stats)
+    mips=$(stat "MIPS" $stats)
+    ns=$(stat "ns/instruction" $stats)
+
+    printf "%-12s %-12s %14s %10s %10s %12s %12s\n" $kernel $mode $instructions $mips $ns $rss $startup
+    # entries are closed without a newline so the next one can add the separating comma
+    if [ $first -eq 0 ]; then echo "," >> $OUTPUT; fi
+    first=0
+    {
+      echo "    {"
+      echo "      \"kernel\": \"$kernel\","
+      echo "      \"mode\": \"$mode\","
+      echo "      \"instructions\": $instructions,"
+      echo "      \"execution_us\": $execution,"
+      echo "      \"mips\": $mips,"
+      echo "      \"ns_per_instruction\": $ns,"
+      echo "      \"peak_rss_kib\": $rss,"
+      echo "      \"startup_us\": $startup"
+      printf "    }"
+    } >> $OUTPUT
+  done
+done
+
+{
+  echo
+  echo "  ]"
+  echo "}"
+} >> $OUTPUT
+echo "results written to $OUTPUT"
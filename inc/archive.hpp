@@ -0,0 +1,48 @@
+#ifndef _archive_hpp_
+#define _archive_hpp_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define ARCHIVE_MAGIC "OBJARCH1"
+
+struct ArchiveMember {
+  std::string_view name;
+  std::string_view contents; // the member's object file
+};
+
+// Bundle of object files with an index of the globals they define, so a linker can find the member
+// it needs without reading the others. After the magic come the number of members, the number of
+// index entries and the size of the name pool, then the member table (name offset and length,
+// contents offset and length, offsets from the start of the archive), the index sorted by name
+// (name offset and length, member), the name pool and finally the members' contents.
+// Everything points into the data passed to read(), which has to outlive the Archive.
+class Archive {
+public:
+  static bool isArchive(const char* data, size_t size); // only checks the magic
+
+  // False if the tables are truncated, point outside of the archive or the index is not sorted.
+  bool read(const char* data, size_t size);
+  std::string getError() const { return error; }
+
+  int findSymbol(std::string_view name) const; // member defining the global, -1 if none
+  int symbolCount() const { return numOfSymbols; }
+  std::string_view symbolName(int k) const;
+  int symbolMember(int k) const;
+
+  std::vector<ArchiveMember> members;
+
+private:
+  const char* index = nullptr; // numOfSymbols fixed size entries, read in place
+  int numOfSymbols = 0;
+  std::string_view names;
+  std::string error;
+};
+
+// Member names are the file names without their directories. Fails if a file is not a valid
+// object file or two of them define the same global, since the index can name only one.
+bool writeArchive(const std::string& file, const std::vector<std::string>& objectFiles, std::string& error);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef _batch_hpp_
+#define _batch_hpp_
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "emulator.hpp"
+
+struct BatchResult {
+  std::string image;
+  int status; // EMULATOR_ status of the run
+  std::string stopReason;
+  unsigned long long instructions;
+  unsigned long long cycles;
+  int gp_regs[GP_REGS_NUM];
+  int cs_regs[CS_REGS_NUM];
+  unsigned long long memoryHash;
+};
+
+// Runs every image named in a list file (one path per line, '#' starts a comment) on a thread pool
+// and writes the final state of each run to a single JSON file, or CSV if the name ends in ".csv".
+class Batch {
+public:
+  Batch(std::string listFile, unsigned int threads, std::string outputFile);
+
+  // configure is applied to each emulator before its run, returns the worst status of all runs
+  int run(std::function<void(Emulator&)> configure);
+
+private:
+  bool readList();
+  void runImage(BatchResult& result, std::function<void(Emulator&)>& configure);
+  void writeJson(std::ostream& out);
+  void writeCsv(std::ostream& out);
+
+  std::string listFile;
+  unsigned int threads;
+  std::string outputFile;
+  std::vector<BatchResult> results; // in list order
+};
+
+#endif
@@ -4,8 +4,22 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
 #include <iomanip>
+#include <chrono>
 #include <fstream>
+#include "memory.hpp"
+#include "jit.hpp"
+#include "timer.hpp"
+#include "terminal.hpp"
+#include "snapshot.hpp"
+#include "profiler.hpp"
+#include "symbol_map.hpp"
+#include "tracer.hpp"
+#include "event_log.hpp"
+#include "gdb_stub.hpp"
 
 #define PC 15
 #define SP 14
@@ -14,6 +28,34 @@
 #define HANDLER 1
 #define CAUSE 2
 
+// values of the cause register
+#define CAUSE_BAD_INSTRUCTION 1
+#define CAUSE_TIMER 2
+#define CAUSE_TERMINAL 3
+#define CAUSE_SOFTWARE 4
+
+// status register bits, a set bit masks the interrupt
+#define STATUS_TIMER_MASK 0x1
+#define STATUS_TERMINAL_MASK 0x2
+#define STATUS_INTERRUPT_MASK 0x4
+
+#define MMIO_BASE 0xFFFFFF00 // device registers live above this address
+
+#define GP_REGS_NUM 16
+#define CS_REGS_NUM 3
+
+#define INSTRUCTION_CACHE_BITS 16
+#define INSTRUCTION_CACHE_SIZE (1 << INSTRUCTION_CACHE_BITS)
+
+#define MAX_BLOCK_INSTRUCTIONS 64
+
+#define CLOCK_CHECK_INTERVAL (1 << 20) // instructions between wall-clock budget checks
+
+// exit statuses of the emulator
+#define EMULATOR_LOAD_FAILED -1
+#define EMULATOR_HALTED 0
+#define EMULATOR_BUDGET_EXHAUSTED 2
+
 enum OP_CODES {
   HALT = 0b00000000,
   INT = 0b00010000,
@@ -48,6 +90,40 @@ enum OP_CODES {
   BGT_MEM_A_D = 0b00111011,
 };
 
+// Mnemonic of an opcode, for profiles and traces.
+inline const char* opcodeName(unsigned char code) {
+  switch (code) {
+    case OP_CODES::HALT: return "HALT";
+    case OP_CODES::INT: return "INT";
+    case OP_CODES::CALL_MEM_A_B_D: return "CALL";
+    case OP_CODES::XCHG: return "XCHG";
+    case OP_CODES::PUSH: return "PUSH";
+    case OP_CODES::POP: return "POP";
+    case OP_CODES::CSR_WR_MEM_UPDATE: return "CSR_POP";
+    case OP_CODES::ADD: return "ADD";
+    case OP_CODES::SUB: return "SUB";
+    case OP_CODES::MUL: return "MUL";
+    case OP_CODES::DIV: return "DIV";
+    case OP_CODES::NOT: return "NOT";
+    case OP_CODES::AND: return "AND";
+    case OP_CODES::OR: return "OR";
+    case OP_CODES::XOR: return "XOR";
+    case OP_CODES::SHL: return "SHL";
+    case OP_CODES::SHR: return "SHR";
+    case OP_CODES::CSRRD: return "CSRRD";
+    case OP_CODES::CSRWR: return "CSRWR";
+    case OP_CODES::LD_B_D: return "LD";
+    case OP_CODES::LD_MEM_B_C_D: return "LD_MEM";
+    case OP_CODES::ST_MEM: return "ST_MEM";
+    case OP_CODES::ST_MEM_MEM: return "ST_MEM_MEM";
+    case OP_CODES::JMP_MEM_A_D: return "JMP";
+    case OP_CODES::BEQ_MEM_A_D: return "BEQ";
+    case OP_CODES::BNE_MEM_A_D: return "BNE";
+    case OP_CODES::BGT_MEM_A_D: return "BGT";
+    default: return "BAD";
+  }
+}
+
 struct Instruction {
   OP_CODES M;
   unsigned char A;
@@ -56,41 +132,244 @@ struct Instruction {
   unsigned int D;
 };
 
+// Dense index of a handler in the dispatch table, one per OP_CODES value
+// followed by the micro-ops that only exist inside translated blocks.
+enum HANDLER_ID : unsigned char {
+  H_HALT,
+  H_INT,
+  H_CALL_MEM_A_B_D,
+  H_XCHG,
+  H_PUSH,
+  H_POP,
+  H_CSR_WR_MEM_UPDATE,
+  H_ADD,
+  H_SUB,
+  H_MUL,
+  H_DIV,
+  H_NOT,
+  H_AND,
+  H_OR,
+  H_XOR,
+  H_SHL,
+  H_SHR,
+  H_CSRRD,
+  H_CSRWR,
+  H_LD_B_D,
+  H_LD_MEM_B_C_D,
+  H_ST_MEM,
+  H_ST_MEM_MEM,
+  H_JMP_MEM_A_D,
+  H_BEQ_MEM_A_D,
+  H_BNE_MEM_A_D,
+  H_BGT_MEM_A_D,
+  H_BAD_INSTRUCTION,
+
+  H_LD_LITERAL, // LD_MEM_B_C_D with PC as base, address folded at translation
+  H_LD_LITERAL_PUSH, // H_LD_LITERAL fused with a push of the loaded register
+  H_SYNC_PC, // stores the instruction's PC before an instruction that reads it
+  H_EXIT, // leaves the block falling through to d
+  H_EXIT_DYNAMIC, // leaves the block after an instruction wrote PC
+  H_BREAKPOINT, // debugger breakpoint, stops before the instruction at d
+  HANDLERS_NUM
+};
+
+struct DecodedInstruction {
+  unsigned int pc; // tag, address the instruction was decoded from
+  bool valid;
+  HANDLER_ID handler;
+  Instruction instruction;
+};
+
+struct MicroOp {
+  HANDLER_ID handler;
+  unsigned char a;
+  unsigned char b;
+  unsigned char c;
+  unsigned int d;
+  int e;
+  unsigned int nextPc; // PC value seen by the instruction, where execution resumes if the block is left after it
+  unsigned int retired; // instructions of the block retired once this op completes
+  unsigned int cycles; // guest cycles of the block spent once this op completes
+};
+
+// Straight-line run of guest code ending at a control transfer, translated once into micro-ops.
+struct Block {
+  unsigned int startPc;
+  unsigned int instructions;
+  std::vector<MicroOp> ops;
+  Block* successors[2]; // last block reached through the taken (0) and fall-through (1) exit
+  NativeBlock native; // compiled code once the block got hot, nullptr otherwise
+  unsigned long long executions;
+  unsigned long long retired;
+  std::vector<unsigned char> opcodes; // per instruction, only while profiling
+  std::vector<unsigned int> words; // raw instruction words, only while tracing
+  std::vector<unsigned long long> profile; // runs by number of instructions retired, only while profiling
+};
+
+// One self-contained machine, several of them can run on different threads at the same time.
 class Emulator {
 public:
-  static Emulator& getInstance() {
-    static Emulator instance;
-    return instance;
-  }
+  Emulator();
+  ~Emulator();
 
   void setInputFile(std::string str);
-  void execute();
+  void setConsole(bool boolean); // without a console the terminal gets no input and its output is dropped
+  void setProfile(bool boolean); // writes profile.txt and profile.folded after the run
+  void setSymbolFile(std::string str);
+  void setMapFile(std::string str); // linker map for symbol+offset in the register dump, "program.map" beside the image by default
+  void setTraceFile(std::string str); // records every retired instruction, runs without the JIT
+  void setRecordFile(std::string str); // logs terminal input, device interrupts and time budget stops
+  void setReplayFile(std::string str); // takes those from a recorded log instead, at the same instruction counts
+  void setGdb(std::string str); // runs under a gdb connected to ":PORT", "HOST:PORT" or a Unix socket path
+  void setStats(bool boolean);
+  void setBlockStats(bool boolean);
+  void setMaxInstructions(unsigned long long num); // 0 means unlimited, same for cycles and time
+  void setMaxCycles(unsigned long long num);
+  void setMaxTime(unsigned long long milliseconds);
+  void setJit(bool boolean);
+  void setJitVerify(bool boolean);
+  void setJitThreshold(unsigned int count); // block executions before it gets compiled, JIT_THRESHOLD by default
+  int execute(); // runs and prints the results, returns the exit status of the emulator
+  int run(); // runs without printing anything, returns one of the EMULATOR_ statuses
+
+  int getRegister(int index) const { return gp_regs[index]; }
+  int getCsr(int index) const { return cs_regs[index]; }
+  unsigned long long getRetiredInstructions() const { return retiredInstructions; }
+  unsigned long long getCycles() const { return cycles; }
+  std::string getStopReason() const { return stopReason; }
+  unsigned long long memoryHash(); // FNV-1a over the address and value of every written byte
+
+  // A snapshot holds registers, CSRs, device state, counters and every allocated page.
+  void setRestoreFile(std::string str);
+  void setSaveFile(std::string str);
+  bool saveSnapshot(std::string file);
+  bool restoreSnapshot(std::string file);
+  std::unique_ptr<Snapshot> takeSnapshot();
+  bool restoreSnapshot(const Snapshot& snapshot);
 
 private:
-  Emulator();
+  friend class Jit;
+  friend class GdbStub;
 
   Emulator(const Emulator&) = delete;
   Emulator& operator=(const Emulator&) = delete;
 
+  void reset();
   bool readInputFile();
+  unsigned char* mapFile(int fd, size_t size);
+  void unmapFiles();
+  bool writeSnapshot(int fd);
+  bool mapSnapshot(int fd);
   void printRegisters();
+  std::string describeAddress(unsigned int address); // hex, with symbol+offset if it is inside the program
   void memoryDump();
-  void fetchInstruction();
-  void executeInstruction();
+  void printStats();
+  void printBlockStats();
+  const DecodedInstruction& fetchInstruction(unsigned int pc);
+  void decodeInstruction(DecodedInstruction& entry, unsigned int pc);
+
+  Block* findBlock(unsigned int pc);
+  Block* translateBlock(unsigned int pc, unsigned int maxInstructions);
+  void flushBlocks();
+  template <bool TRACE>
+  unsigned int runBlock(Block* block);
+  int traceRead(unsigned int address);
+  void traceWrite(int data, unsigned int address);
+  void traceOp(const Block* block, const MicroOp* op);
+  void compileBlock(Block* block);
+  bool checkBudget();
+  void executeBlocks();
+  template <bool PROFILE, bool TRACE>
+  void executeBlocksLoop();
+  bool raisePendingException();
+  void raiseInterrupt(int cause);
+  bool deliverInterrupts();
+  bool replayEvents();
+  void updateCycleLimit();
+  void writeDevice(unsigned int address, int data);
+  void setBreakpoint(unsigned int address, bool enabled);
+  void writeDebugByte(unsigned int address, unsigned char value);
+  bool verifyJit();
 
   int readFourBytes(unsigned int address);
   void writeFourBytes(int data, unsigned int address);
+  void invalidateInstructions(unsigned int address);
+
+  // called from compiled blocks
+  static int jitReadFourBytes(Emulator* emulator, unsigned int address);
+  static int jitWriteFourBytes(Emulator* emulator, int data, unsigned int address);
 
   std::string inputFileStr;
+  std::string symbolFileStr;
+  std::string mapFileStr;
+  SymbolMap symbolMap;
+  bool hasMap;
+  std::string traceFileStr;
+  std::string recordFileStr;
+  std::string replayFileStr;
+  std::string gdbAddressStr;
+  std::string restoreFileStr; // snapshot to start from instead of the input file
+  std::string saveFileStr; // where to save a snapshot once the run stops
+  std::vector<std::pair<unsigned char*, size_t>> mappings; // input file and snapshots backing guest pages
+  size_t snapshotSize; // bytes of the last snapshot written or restored
+
+  int gp_regs[GP_REGS_NUM];
+  int cs_regs[CS_REGS_NUM];
+  Memory memory;
+
+  std::vector<DecodedInstruction> instructionCache; // direct mapped, indexed by (pc >> 2)
+  std::unordered_map<unsigned int, std::unique_ptr<Block>> blocks; // key == start PC
+  Jit jit;
+  unsigned long long blocksTranslated;
+  unsigned long long blocksCompiled;
+  unsigned long long retiredInstructions;
+  unsigned long long cycles;
+
+  unsigned long long maxInstructions;
+  unsigned long long maxCycles;
+  unsigned long long maxMilliseconds;
+  unsigned long long nextCheckpoint; // retired instruction count at which checkBudget runs again
+  unsigned long long cycleLimit; // next cycle count that needs attention: cycle budget, timer tick or terminal poll
+  std::chrono::steady_clock::time_point executionStart;
+  unsigned long long startupMicroseconds;
+  unsigned long long executionMicroseconds;
+  std::string stopReason;
+
+  Timer timer;
+  bool timerPending; // tick arrived while the timer interrupt was masked
+  Terminal terminal;
+  bool terminalPending; // character is in term_in but the interrupt was not delivered yet
+  unsigned long long nextTerminalPoll;
 
-  std::vector<int> gp_regs;
-  std::vector<int> cs_regs;
-  std::map<unsigned int, unsigned char> memory;
+  EventLog events; // being recorded, or being replayed
+  bool recording;
+  bool replaying; // devices raise nothing, every external event comes from the log
+  bool replayStopped; // reached the point where the recorded run ran out of time
+  size_t nextEvent; // next one to replay
 
-  Instruction nextInstruction;
+  std::unique_ptr<GdbStub> debugger; // nullptr unless a debugger is attached
+  std::unordered_set<unsigned int> breakpoints; // patched into the decoded instructions as H_BREAKPOINT
+  unsigned long long debugStop; // retired instruction count at which a single-step returns to the debugger
+  bool breakpointHit;
 
   bool badInstruction;
+  bool codeModified; // a store hit translated code, blocks must be flushed
   bool halted;
+  std::unique_ptr<Profiler> profiler; // nullptr unless profiling
+  std::unique_ptr<Tracer> tracer; // nullptr unless tracing
+  bool tracing; // the trace file of the last run was written
+  unsigned char traceAccess; // TRACE_LOAD / TRACE_STORE seen by the op being traced
+  unsigned int traceLoadAddress;
+  int traceLoadData;
+  unsigned int traceStoreAddress;
+  int traceStoreData;
+  bool console;
+  bool jitPassed;
+  bool stats;
+  bool blockStats;
+  bool jitEnabled;
+  bool jitVerify;
+  unsigned int jitThreshold;
 };
 
 #endif
\ No newline at end of file
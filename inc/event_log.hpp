@@ -0,0 +1,38 @@
+#ifndef _event_log_hpp_
+#define _event_log_hpp_
+
+#include <string>
+#include <vector>
+
+#define EVENT_LOG_MAGIC "EMUEVNT1"
+
+// Event.cause, besides the interrupt causes of the cause register
+#define EVENT_TERMINAL_INPUT 0 // payload is the character placed in term_in
+#define EVENT_STOP -1 // the recorded run ran out of wall-clock time here
+
+// Something that happened to the machine from outside, at the boundary where retired
+// instructions reached the given count. Interrupt events carry the cause that was raised.
+struct Event {
+  unsigned long long retired;
+  int cause;
+  int payload;
+};
+
+// Events in the order they happened. The file is the magic, the number of events and the
+// events themselves.
+class EventLog {
+public:
+  void clear() { events.clear(); }
+  void add(unsigned long long retired, int cause, int payload);
+
+  bool read(std::string file);
+  bool write(std::string file) const;
+
+  size_t size() const { return events.size(); }
+  const Event& at(size_t index) const { return events[index]; }
+
+private:
+  std::vector<Event> events;
+};
+
+#endif
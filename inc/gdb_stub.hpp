@@ -0,0 +1,50 @@
+#ifndef _gdb_stub_hpp_
+#define _gdb_stub_hpp_
+
+#include <string>
+
+class Emulator;
+
+// GDB remote serial protocol over TCP or a Unix socket, one debugger at a time.
+// Registers go out in the order r0-r15 (r15 is the PC), status, handler, cause, 32 bits each.
+// Supports register and memory access, software breakpoints (Z0/z0), continue, single-step,
+// interrupting a running guest with ^C, detach and kill.
+class GdbStub {
+public:
+  GdbStub(Emulator& emulator);
+  ~GdbStub();
+
+  // address is ":PORT" or "HOST:PORT" (host defaults to loopback) or the path of a Unix socket.
+  // Waits until the debugger connects.
+  bool listen(std::string address);
+  // Answers the debugger until the guest halts or runs out of budget, or the debugger kills it
+  // (returns false) or detaches or disconnects (returns true, the guest should keep running).
+  bool serve();
+  // Checked while the guest runs, true once the debugger sent ^C.
+  bool interruptRequested();
+
+private:
+  GdbStub(const GdbStub&) = delete;
+  GdbStub& operator=(const GdbStub&) = delete;
+
+  bool readByte(char& c);
+  bool readPacket(std::string& packet);
+  void sendPacket(const std::string& data);
+
+  std::string readRegisters();
+  std::string readMemory(unsigned int address, unsigned int length);
+  bool writeMemory(unsigned int address, unsigned int length, const std::string& data);
+  std::string resume(bool step);
+  void runFor(unsigned long long instructions);
+  std::string stopReply();
+
+  Emulator& emulator;
+  int listenFd;
+  int fd;
+  std::string socketPath; // unlinked once the debugger is gone
+  bool noAck;
+  bool exited; // the last stop reply told the debugger the guest is gone
+  std::string pending; // bytes that arrived while the guest was running
+};
+
+#endif
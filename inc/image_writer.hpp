@@ -0,0 +1,25 @@
+#ifndef _image_writer_hpp_
+#define _image_writer_hpp_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#define IMAGE_CHUNK_SIZE (64 * 1024) // bytes of the image formatted by one task
+#define IMAGE_WINDOW_CHUNKS 16 // chunks formatted before they are written
+
+// One merged section of the linked image, contents owned by the caller.
+struct ImageSection {
+  unsigned int address;
+  const unsigned char* data;
+  size_t length;
+};
+
+// Writes the image as the .lnk file and as hex text ("address: xx xx ..." with 8 bytes per line,
+// a new line at the start of every section) in one pass over the sections. The text size of each
+// chunk is known up front, so the chunks of a window are formatted in parallel with a lookup
+// table, then the window goes out with one writev per file, the binary contents straight from
+// the image. An empty file name skips that file.
+bool writeImageFiles(const std::vector<ImageSection>& sections, const std::string& binaryFile, const std::string& textFile, unsigned int threads);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef _jit_hpp_
+#define _jit_hpp_
+
+#include <vector>
+#include <cstddef>
+
+#define JIT_BUFFER_SIZE (16 * 1024 * 1024)
+#define JIT_THRESHOLD 64 // block executions before it gets compiled
+
+struct Block;
+struct MicroOp;
+class Emulator;
+
+// Compiled block: returns (exit op index << 1) | exit slot, same as Emulator::runBlock.
+typedef unsigned int (*NativeBlock)(int* gp_regs, Emulator* emulator, int* cs_regs);
+
+// Translates blocks of micro-ops into x86-64 code placed in an mmap'd buffer.
+// Guest registers stay in the emulator's arrays: rbx points to gp_regs, r13 to cs_regs
+// and r12 holds the emulator, memory accesses call back into the emulator.
+class Jit {
+public:
+  Jit();
+  ~Jit();
+
+  static bool canCompile(const Block* block);
+  NativeBlock compile(const Block* block); // nullptr when the buffer is full
+  void reset();
+
+private:
+  Jit(const Jit&) = delete;
+  Jit& operator=(const Jit&) = delete;
+
+  void compileOp(const MicroOp& op, unsigned int index);
+
+  void emitByte(unsigned char b);
+  void emitWord(unsigned int w);
+  void emitLoad(int reg, bool csr, int index);
+  void emitStore(bool csr, int index, int reg);
+  void emitAluMem(unsigned char opcode, int reg, int index);
+  void emitAddImmediate(int reg, unsigned int imm);
+  void emitMovImmediate(int reg, unsigned int imm);
+  void emitStorePc(unsigned int pc);
+  void emitCall(const void* function);
+  void emitReadCall();
+  void emitWriteCall();
+  void emitExit(unsigned int index, int slot);
+  void emitExitIfCodeModified(const MicroOp& op, unsigned int index);
+  size_t emitJccForward(unsigned char condition);
+  void patchJump(size_t position);
+
+  unsigned char* buffer;
+  size_t used;
+  std::vector<unsigned char> code; // block being compiled
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef _link_cache_hpp_
+#define _link_cache_hpp_
+
+#include <string>
+#include <vector>
+
+#define LINK_CACHE_MAGIC "LNKCACH1"
+
+// One input file's part of a merged section.
+struct CachedPart {
+  std::string section;
+  int length;
+  int sectionIndex; // in LinkCache::sections
+  int offset; // from the start of the merged section
+};
+
+struct CachedInput {
+  std::string file;
+  unsigned long long hash; // of the whole file
+  std::vector<CachedPart> parts; // in the order of the file's section table
+};
+
+struct CachedSection {
+  std::string name;
+  int address;
+  int length;
+};
+
+// kind is 'g' (global), 'l' (local) or 's' (section), as in the .sym file
+struct CachedSymbol {
+  std::string name;
+  int fileId;
+  int value; // final address
+  char kind;
+};
+
+// A relocation that was resolved to a global symbol.
+struct CachedSite {
+  int fileId; // whose relocation it is
+  int sectionIndex; // in LinkCache::sections
+  int offset; // from the start of the merged section
+  int symbol; // in LinkCache::symbols
+};
+
+// What a link produced, kept next to the output so the next link can patch the output when
+// only the contents of some inputs changed. Sections are in address order, the same order
+// as in the .lnk file, and globals come first in symbols.
+struct LinkCache {
+  std::string options; // placed sections, the cache is only used with the same ones
+  std::vector<CachedInput> inputs;
+  std::vector<CachedSection> sections;
+  std::vector<CachedSymbol> symbols;
+  std::vector<CachedSite> sites;
+
+  bool read(const std::string& file);
+  bool write(const std::string& file) const;
+
+  long long imageOffset(int sectionIndex) const; // of the section's contents in the .lnk file
+  long long imageSize() const; // of the whole .lnk file
+};
+
+unsigned long long hashBytes(const char* data, size_t size);
+
+#endif
@@ -4,28 +4,50 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstring>
 #include <vector>
 #include <map>
 #include <iomanip>
-
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include "archive.hpp"
+#include "link_cache.hpp"
+#include "object_file.hpp"
+#include "symbol_index.hpp"
+
+// Names and section contents point into the mapped input files.
 struct SectionTableEntry {
   int id;
-  std::string name;
-  int offset;
+  std::string_view name;
+  int nameId; // in Linker::strings
+  int offset; // of this file's part from the start of the merged section
   int length;
-  bool hasFollowUp = false;
   int fileId;
+  int mergedId; // index in Linker::mergedSections, -1 if not live
+  bool live; // false once -gc-sections found that nothing refers to it
+  std::string_view data;
+};
+
+// All parts of one section name, laid out in input file order.
+struct MergedSection {
+  std::string name;
+  int offset; // from start of program, i.e. the address
+  int length;
   bool hasExplicitPlace = false;
+  size_t imageOffset; // of its contents in Linker::image
+  std::vector<std::pair<int, int>> parts; // (file index, position in its section table)
 };
 
 struct SymbolTableEntry {
   int id;
-  std::string name;
+  std::string_view name;
+  int nameId; // in Linker::strings
   int value;
   bool isGlobal;
   bool isExtern;
   bool isDefined;
-  std::string section;
+  int sectionIndex; // position in the file's section table, -1 if the file has no such section
   int fileId; // index of file which it belongs to
 };
 
@@ -35,10 +57,11 @@ enum RELOC_TYPE {
 };
 
 struct RelocationTableEntry {
-  std::string section;
-  int offset;
+  int sectionIndex; // position in the file's section table, -1 if the file has no such section
+  int offset; // from the start of the file's part of the section
   RELOC_TYPE type;
-  std::string symbol;
+  std::string_view symbol;
+  int symbolId; // in Linker::strings
   int addend;
 };
 
@@ -49,16 +72,21 @@ public:
     return instance;
   }
 
-  void analizeInputFiles();
+  bool analizeInputFiles();
   void mergeSections();
-  void createBinaryFile();
-  void createTextFile();
+  void createImageFiles(bool binary); // the .lnk file only if binary, the text output always
+  void createSymbolFile();
+  void createMapFile();
   bool link();
   
   void setOutput(std::string str);
   void addInputFile(std::string str);
   void addPlacedSection(std::string w, int loc);
   void setIsHex(bool boolean);
+  void setThreads(unsigned int count); // 0 means one per core
+  void setIncremental(bool boolean);
+  void setGcSections(bool boolean);
+  void setEntrySymbol(std::string str); // root for -gc-sections besides the placed sections
   void printOutputFileName();
 
 private:
@@ -67,38 +95,64 @@ private:
   Linker(const Linker&) = delete;
   Linker& operator=(const Linker&) = delete;
 
-  void determineSectionOffsetsFromFirstInstanceOfSection();
-  void updateOffsetsOfTables();
-  void mergeSectionStringstreams();
-  void determineSectionLengths();
+  bool loadInputFiles(int first);
+  bool extractArchiveMembers();
+  bool readInputFile(int i, std::vector<SymbolTableEntry>& symbols, std::string& error);
+  void indexSections();
+  void buildImage();
   void determineSectionOffsetsFromStartOfProgram();
-  void determineSymbolAndRelocOffsetsFromStartOfFile();
+  void determineSymbolValues();
+  bool collectGarbageSections();
+  bool isDiscarded(const SymbolTableEntry& symbol); // defined in a section that is not live
   void relocateSymbolInstances();
+  int findMergedSection(const std::string& name);
   bool checkForOverlappedPlaceSections();
   bool checkAndPrintMultipleDefinitions();
   void putAndSortSectionsIntoOneVector();
+  void recordLinkState();
+  bool relinkIncrementally();
+  std::string outputFileName(const std::string& extension);
+  std::string linkOptions();
 
 
+  // Object files from the command line, then archive members in the order they were extracted,
+  // named "archive(member)". Contents point into mappedFiles.
   std::vector<std::string> inputFiles;
-
-  std::map<std::string, std::vector<SymbolTableEntry>> symbolTablesForEachFile; // key == INPUTFILE NAME
+  std::vector<std::string_view> inputContents;
+  std::vector<std::unique_ptr<MappedFile>> mappedFiles; // kept until the output is written
+  std::vector<std::pair<std::string, Archive>> archives; // (file, index) in command line order
+  std::vector<unsigned long long> inputHashes; // only with incremental
+
+  // indexed by file
+  std::vector<std::vector<SymbolTableEntry>> symbolTablesForEachFile;
+  std::vector<std::vector<SectionTableEntry>> sectionTableForEachFile;
+  std::vector<std::vector<RelocationTableEntry>> relocTableForEachFile;
   std::vector<SymbolTableEntry> globalSymbolTable;
 
-  std::map<std::string, std::vector<SectionTableEntry>> sectionTableForEachFile;
-
-  std::map<std::string, std::vector<RelocationTableEntry>> relocTableForEachFile;
-
-  std::map<std::string, std::map<std::string, std::stringstream>> stringstreamPerSectionPerFile;
-  std::map<std::string, std::stringstream> stringstreamPerMergedSection;
+  std::vector<MergedSection> mergedSections; // in order of first appearance
+  std::vector<int> mergedSectionOfName; // by string id, -1 if not a section name
+  std::vector<int> sectionsByAddress; // indices in mergedSections
+  std::vector<unsigned char> image; // contents of the merged sections, one after another in address order
 
   std::vector<std::pair<std::string, int>> sectionsWithPlaceOption;
 
-  std::map<std::string, int> symbolTimesDefined;
+  // Every symbol and relocation name is interned once while reading the inputs. symbolIndex maps
+  // (file index, name) to the position in symbolTablesForEachFile and (GLOBAL_SCOPE, name) to the
+  // position in globalSymbolTable.
+  StringTable strings;
+  SymbolIndex symbolIndex;
+  std::vector<std::string> multiplyDefinedSymbols;
 
-  std::vector<SectionTableEntry> mergedSections;
+  // Symbols with their final values, and with incremental linking also what the next link needs,
+  // written to "<output>.cache".
+  LinkCache linkState;
 
   std::string outfileStr;
   bool isHex;
+  unsigned int threads;
+  bool incremental;
+  bool gcSections;
+  std::string entrySymbol;
 };
 
 #endif
\ No newline at end of file
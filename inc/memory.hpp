@@ -0,0 +1,134 @@
+#ifndef _memory_hpp_
+#define _memory_hpp_
+
+#include <cstring>
+
+#define GUEST_PAGE_BITS 12
+#define GUEST_PAGE_SIZE (1 << GUEST_PAGE_BITS)
+#define GUEST_TABLE_BITS 10
+#define GUEST_TABLE_SIZE (1 << GUEST_TABLE_BITS)
+#define GUEST_DIRECTORY_SIZE (1 << (32 - GUEST_PAGE_BITS - GUEST_TABLE_BITS))
+
+struct Page {
+  unsigned char* data; // owned, or pointing into a mapped image when mapped is set
+  bool mapped;
+  unsigned char written[GUEST_PAGE_SIZE / 8]; // one bit per byte, set once the byte has been stored to
+  unsigned char code[GUEST_PAGE_SIZE / 8]; // one bit per byte, set once the byte was decoded as an instruction
+  bool hasCode;
+  bool codeWritten; // a write hit one of the code bytes
+};
+
+// Sparse guest memory covering the whole 32-bit address space.
+// Address is split into directory index (10 bits), table index (10 bits) and page offset (12 bits),
+// pages are allocated the first time they are written to.
+// Pages fully covered by a loaded image segment use the image's (private, copy-on-write) mapping directly.
+class Memory {
+public:
+  Memory();
+  ~Memory();
+
+  // Writes return true if they overwrote a byte previously marked as code.
+  unsigned char readByte(unsigned int address);
+  bool writeByte(unsigned int address, unsigned char value);
+
+  unsigned int readWord(unsigned int address);
+  bool writeWord(unsigned int address, unsigned int value);
+
+  // Places length bytes of an image at address. source must stay mapped until clear().
+  void load(unsigned int address, unsigned char* source, unsigned int length);
+  // Uses data (a whole page, mapped until clear()) as the page at address, replacing the old one.
+  void mapPage(unsigned int address, unsigned char* data, const unsigned char* written);
+
+  void markCode(unsigned int address);
+  bool isCodeWritten(unsigned int address);
+
+  void clear();
+
+  // Calls f(address, value) for every byte that was ever written, in ascending address order.
+  template <typename F>
+  void forEachWrittenByte(F f);
+
+  // Calls f(base address, page) for every allocated page, in ascending address order.
+  template <typename F>
+  void forEachPage(F f);
+
+private:
+  Memory(const Memory&) = delete;
+  Memory& operator=(const Memory&) = delete;
+
+  Page* findPage(unsigned int address);
+  Page* getPage(unsigned int address);
+  Page*& pageEntry(unsigned int address); // creates the table if needed
+  Page* allocatePage(unsigned int address);
+
+  unsigned int readWordSlow(unsigned int address);
+  bool writeWordSlow(unsigned int address, unsigned int value);
+
+  Page** directory[GUEST_DIRECTORY_SIZE];
+};
+
+inline Page* Memory::findPage(unsigned int address) {
+  Page** table = directory[address >> (GUEST_PAGE_BITS + GUEST_TABLE_BITS)];
+  if (table == nullptr) return nullptr;
+  return table[(address >> GUEST_PAGE_BITS) & (GUEST_TABLE_SIZE - 1)];
+}
+
+inline Page* Memory::getPage(unsigned int address) {
+  Page* page = findPage(address);
+  if (page == nullptr) page = allocatePage(address);
+  return page;
+}
+
+inline unsigned int Memory::readWord(unsigned int address) {
+  unsigned int offset = address & (GUEST_PAGE_SIZE - 1);
+  if (offset > GUEST_PAGE_SIZE - 4) return readWordSlow(address);
+
+  Page* page = findPage(address);
+  if (page == nullptr) return 0;
+
+  unsigned int value;
+  memcpy(&value, page->data + offset, sizeof(value));
+  return value;
+}
+
+inline bool Memory::writeWord(unsigned int address, unsigned int value) {
+  unsigned int offset = address & (GUEST_PAGE_SIZE - 1);
+  if (offset > GUEST_PAGE_SIZE - 4) return writeWordSlow(address, value);
+
+  Page* page = getPage(address);
+  memcpy(page->data + offset, &value, sizeof(value));
+
+  // the 4 written bits may straddle two bytes of the bitmap
+  unsigned int bits = 0xfu << (offset & 7);
+  page->written[offset >> 3] |= bits & 0xff;
+  if (bits > 0xff) page->written[(offset >> 3) + 1] |= bits >> 8;
+
+  if (!page->hasCode) return false;
+  if ((page->code[offset >> 3] & bits) == 0 && (bits <= 0xff || (page->code[(offset >> 3) + 1] & (bits >> 8)) == 0)) return false;
+  page->codeWritten = true;
+  return true;
+}
+
+template <typename F>
+void Memory::forEachWrittenByte(F f) {
+  forEachPage([&](unsigned int base, const Page& page) {
+    for (unsigned int k = 0; k < GUEST_PAGE_SIZE; k++) {
+      if (page.written[k >> 3] & (1 << (k & 7))) f(base + k, page.data[k]);
+    }
+  });
+}
+
+template <typename F>
+void Memory::forEachPage(F f) {
+  for (unsigned int i = 0; i < GUEST_DIRECTORY_SIZE; i++) {
+    if (directory[i] == nullptr) continue;
+
+    for (unsigned int j = 0; j < GUEST_TABLE_SIZE; j++) {
+      Page* page = directory[i][j];
+      if (page == nullptr) continue;
+      f((i << (GUEST_PAGE_BITS + GUEST_TABLE_BITS)) | (j << GUEST_PAGE_BITS), *page);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef _object_file_hpp_
+#define _object_file_hpp_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only mapping of a whole file, unmapped when destroyed.
+class MappedFile {
+public:
+  MappedFile();
+  ~MappedFile();
+
+  bool open(const std::string& file);
+  const char* data() const { return mapping; }
+  size_t size() const { return length; }
+
+private:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  char* mapping;
+  size_t length;
+};
+
+// Cursor over a file's bytes. Once a read would run past the end it fails, and so does every
+// read after it. Values are in host byte order, as the assembler and linker write them.
+class ByteReader {
+public:
+  ByteReader(const char* data, size_t size) : data(data), size(size), position(0), failed(false) {}
+
+  bool readInt(int& value);
+  bool readBool(bool& value);
+  bool readBytes(size_t count, std::string_view& bytes); // points into the data
+  bool readString(std::string_view& str); // int length, then the bytes
+
+  size_t getPosition() const { return position; }
+  bool ok() const { return !failed; }
+
+private:
+  const char* data;
+  size_t size;
+  size_t position;
+  bool failed;
+};
+
+struct ObjectSymbol {
+  std::string_view name;
+  bool isDefined;
+  bool isGlobal;
+  bool isExtern;
+  int value;
+  std::string_view section;
+};
+
+struct ObjectSection {
+  std::string_view name;
+  int id;
+  int length;
+  std::string_view data; // empty when the file has no contents for the section
+};
+
+struct ObjectRelocation {
+  std::string_view section;
+  int offset;
+  int type;
+  std::string_view symbol;
+  int addend;
+};
+
+// Assembler output: symbol table, section table, relocation table and the contents of the
+// sections, each table prefixed by its number of entries. All names and contents point into
+// the data passed to read(), which has to outlive the ObjectFile.
+class ObjectFile {
+public:
+  // False if the file is truncated, has trailing bytes, or has contents for a section that is
+  // not in its section table (or has them twice).
+  bool read(const char* data, size_t size);
+  std::string getError() const { return error; }
+
+  int findSection(std::string_view name) const; // position in sections, -1 if missing
+
+  std::vector<ObjectSymbol> symbols;
+  std::vector<ObjectSection> sections;
+  std::vector<ObjectRelocation> relocations;
+
+private:
+  std::string error;
+};
+
+// Linker output (.lnk): number of segments, then address, length and contents of each one.
+struct ImageSegment {
+  unsigned int address;
+  size_t offset; // of the contents from the start of the file
+  size_t length;
+};
+
+// False if the image is truncated or has trailing bytes.
+bool readImageSegments(const char* data, size_t size, std::vector<ImageSegment>& segments);
+
+#endif
@@ -0,0 +1,133 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_INC_PARSER_HPP_INCLUDED
+# define YY_YY_INC_PARSER_HPP_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    TOKEN_GLOBAL = 258,            /* TOKEN_GLOBAL  */
+    TOKEN_EXTERN = 259,            /* TOKEN_EXTERN  */
+    TOKEN_SECTION = 260,           /* TOKEN_SECTION  */
+    TOKEN_WORD = 261,              /* TOKEN_WORD  */
+    TOKEN_SKIP = 262,              /* TOKEN_SKIP  */
+    TOKEN_ASCII = 263,             /* TOKEN_ASCII  */
+    TOKEN_EQU = 264,               /* TOKEN_EQU  */
+    TOKEN_END = 265,               /* TOKEN_END  */
+    TOKEN_HALT = 266,              /* TOKEN_HALT  */
+    TOKEN_INT = 267,               /* TOKEN_INT  */
+    TOKEN_CALL = 268,              /* TOKEN_CALL  */
+    TOKEN_RET = 269,               /* TOKEN_RET  */
+    TOKEN_IRET = 270,              /* TOKEN_IRET  */
+    TOKEN_JMP = 271,               /* TOKEN_JMP  */
+    TOKEN_BEQ = 272,               /* TOKEN_BEQ  */
+    TOKEN_BNE = 273,               /* TOKEN_BNE  */
+    TOKEN_BGT = 274,               /* TOKEN_BGT  */
+    TOKEN_PUSH = 275,              /* TOKEN_PUSH  */
+    TOKEN_POP = 276,               /* TOKEN_POP  */
+    TOKEN_XCHG = 277,              /* TOKEN_XCHG  */
+    TOKEN_ADD = 278,               /* TOKEN_ADD  */
+    TOKEN_SUB = 279,               /* TOKEN_SUB  */
+    TOKEN_MUL = 280,               /* TOKEN_MUL  */
+    TOKEN_DIV = 281,               /* TOKEN_DIV  */
+    TOKEN_NOT = 282,               /* TOKEN_NOT  */
+    TOKEN_AND = 283,               /* TOKEN_AND  */
+    TOKEN_OR = 284,                /* TOKEN_OR  */
+    TOKEN_XOR = 285,               /* TOKEN_XOR  */
+    TOKEN_SHL = 286,               /* TOKEN_SHL  */
+    TOKEN_SHR = 287,               /* TOKEN_SHR  */
+    TOKEN_LD = 288,                /* TOKEN_LD  */
+    TOKEN_ST = 289,                /* TOKEN_ST  */
+    TOKEN_CSRRD = 290,             /* TOKEN_CSRRD  */
+    TOKEN_CSRWR = 291,             /* TOKEN_CSRWR  */
+    TOKEN_COMMENT = 292,           /* TOKEN_COMMENT  */
+    TOKEN_LITERAL = 293,           /* TOKEN_LITERAL  */
+    TOKEN_SYMBOL = 294,            /* TOKEN_SYMBOL  */
+    TOKEN_LABEL = 295,             /* TOKEN_LABEL  */
+    TOKEN_IMM = 296,               /* TOKEN_IMM  */
+    TOKEN_STRING = 297,            /* TOKEN_STRING  */
+    TOKEN_ENDL = 298,              /* TOKEN_ENDL  */
+    TOKEN_COMMA = 299,             /* TOKEN_COMMA  */
+    TOKEN_GP_REGISTER = 300,       /* TOKEN_GP_REGISTER  */
+    TOKEN_CS_REGISTER = 301,       /* TOKEN_CS_REGISTER  */
+    TOKEN_LEFT_BRACKET = 302,      /* TOKEN_LEFT_BRACKET  */
+    TOKEN_RIGHT_BRACKET = 303,     /* TOKEN_RIGHT_BRACKET  */
+    TOKEN_PLUS = 304               /* TOKEN_PLUS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 16 "misc/parser.y"
+
+    int number;
+    std::string* symbol;
+    struct ArgumentNode* arg;
+
+#line 119 "inc/parser.hpp"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+extern YYSTYPE yylval;
+
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_INC_PARSER_HPP_INCLUDED  */
@@ -0,0 +1,52 @@
+#ifndef _profiler_hpp_
+#define _profiler_hpp_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include "symbol_map.hpp"
+
+struct Block;
+
+// Node of the call tree the folded stacks are printed from.
+struct ProfileNode {
+  int symbol; // index into functions, -1 if unknown
+  int parent;
+  unsigned long long instructions;
+  std::map<int, int> children; // symbol -> node
+};
+
+// Counts retired instructions per PC and per opcode, and follows CALL/ret and interrupts to
+// build a call tree. Blocks carry a histogram of how many of their instructions retired per run,
+// which is folded into the per-PC counts when the block is dropped or the run ends.
+class Profiler {
+public:
+  Profiler();
+
+  bool loadSymbols(std::string file);
+  void clear();
+  void start(unsigned int pc); // roots the call tree at pc's function, once per run
+
+  void recordBlock(Block* block, unsigned int exitIndex, int exitSlot, unsigned int nextPc);
+  void call(unsigned int target);
+  void foldBlock(Block* block);
+
+  bool write(std::string flatFile, std::string foldedFile);
+
+private:
+  int functionAt(unsigned int pc) const;
+  std::string functionName(int function) const;
+  void ret();
+
+  SymbolMap symbols;
+  std::vector<MapSymbol> functions; // global and section symbols, where attribution starts
+
+  std::unordered_map<unsigned int, unsigned long long> pcCounts;
+  unsigned long long opcodeCounts[256];
+  std::map<std::pair<int, int>, unsigned long long> callEdges;
+  std::vector<ProfileNode> nodes;
+  int current;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef _ring_buffer_hpp_
+#define _ring_buffer_hpp_
+
+#include <atomic>
+
+// Lock-free queue for exactly one producer thread and one consumer thread.
+// SIZE must be a power of two; head and tail only ever grow and wrap around naturally.
+template <typename T, unsigned int SIZE>
+class RingBuffer {
+public:
+  RingBuffer() : head(0), tail(0) {}
+
+  bool push(T value) {
+    unsigned int t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == SIZE) return false;
+    items[t & (SIZE - 1)] = value;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T& value) {
+    unsigned int h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) return false;
+    value = items[h & (SIZE - 1)];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  alignas(64) std::atomic<unsigned int> head; // advanced by the consumer
+  alignas(64) std::atomic<unsigned int> tail; // advanced by the producer
+  T items[SIZE];
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef _snapshot_hpp_
+#define _snapshot_hpp_
+
+#include <cstddef>
+#include "memory.hpp"
+
+#define SNAPSHOT_MAGIC "EMUSNAP1"
+
+// Snapshot layout: header, one SnapshotPage per allocated guest page, zero padding up to
+// a multiple of GUEST_PAGE_SIZE, then the contents of the pages in the same order.
+// Page contents are page aligned so a restore can map them instead of reading them.
+struct SnapshotHeader {
+  char magic[8];
+  unsigned int pages;
+  int gp_regs[16];
+  int cs_regs[3];
+  unsigned long long retiredInstructions;
+  unsigned long long cycles;
+  unsigned long long timerPeriod;
+  unsigned long long timerDeadline;
+  unsigned long long nextTerminalPoll;
+  unsigned char timerPending;
+  unsigned char terminalPending;
+};
+
+struct SnapshotPage {
+  unsigned int address;
+  unsigned char written[GUEST_PAGE_SIZE / 8];
+};
+
+size_t snapshotDataOffset(unsigned int pages);
+bool writeAll(int fd, const void* data, size_t size);
+
+// Snapshot kept in memory, in an anonymous file. Every restore maps it privately, so any number
+// of emulators can start from it and only the pages they write get copied.
+class Snapshot {
+public:
+  Snapshot();
+  ~Snapshot();
+
+  bool isValid() const { return fd >= 0; }
+  int getFd() const { return fd; }
+  size_t getSize() const { return size; }
+  void setSize(size_t size) { this->size = size; }
+
+private:
+  Snapshot(const Snapshot&) = delete;
+  Snapshot& operator=(const Snapshot&) = delete;
+
+  int fd;
+  size_t size;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef _symbol_index_hpp_
+#define _symbol_index_hpp_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define GLOBAL_SCOPE -1 // scope of global symbols in SymbolIndex, local symbols use their file index
+
+// Interned strings: every distinct string gets a small integer id, handed out in order of first appearance.
+// Open addressing with linear probing over ids, the table is kept at most half full.
+class StringTable {
+public:
+  StringTable();
+
+  int intern(std::string_view str);
+  int find(std::string_view str) const; // -1 if the string was never interned
+  const std::string& at(int id) const { return strings[id]; }
+  int size() const { return strings.size(); }
+
+private:
+  unsigned int probeStart(unsigned int hash) const { return hash & (slots.size() - 1); }
+  void grow();
+
+  std::vector<std::string> strings;
+  std::vector<unsigned int> hashes; // hash of each string, kept for rehashing
+  std::vector<int> slots; // string ids, -1 when empty
+};
+
+// Maps (scope, interned name) to a value, usually the symbol's position in its table.
+class SymbolIndex {
+public:
+  SymbolIndex();
+
+  bool insert(int scope, int nameId, int value); // false (and the old value kept) if the key is already there
+  int find(int scope, int nameId) const; // -1 if missing
+  void clear();
+
+private:
+  struct Slot {
+    unsigned long long key;
+    int value;
+  };
+
+  static unsigned long long makeKey(int scope, int nameId) {
+    return ((unsigned long long)(unsigned int)(scope + 1) << 32) | (unsigned int)nameId;
+  }
+  unsigned int probeStart(unsigned long long key) const;
+  void grow();
+
+  std::vector<Slot> slots;
+  unsigned int used;
+};
+
+#endif
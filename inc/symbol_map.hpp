@@ -0,0 +1,37 @@
+#ifndef _symbol_map_hpp_
+#define _symbol_map_hpp_
+
+#include <string>
+#include <vector>
+
+struct MapSymbol {
+  unsigned int address;
+  char kind; // g (global), s (section) or l (local), as written by the linker
+  std::string name;
+};
+
+struct MapSection {
+  unsigned int address;
+  unsigned int size;
+  std::string name;
+};
+
+// Addresses of a linked program, read from the linker's .map file ("section address size name",
+// "part address size file" and "symbol address kind name file" lines) or from its .sym file
+// ("address kind name" lines, no sections). Both are kept sorted by address, lookups are
+// binary searches.
+class SymbolMap {
+public:
+  bool load(const std::string& file);
+
+  const std::vector<MapSymbol>& getSymbols() const { return symbols; }
+  int symbolAt(unsigned int address) const; // last symbol at or below address, -1 if none
+  std::string location(unsigned int address) const; // "symbol+0xoffset", empty if no symbol is below
+  bool inSection(unsigned int address) const;
+
+private:
+  std::vector<MapSymbol> symbols; // for equal addresses the section comes first, so a global wins lookups
+  std::vector<MapSection> sections;
+};
+
+#endif
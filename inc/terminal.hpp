@@ -0,0 +1,44 @@
+#ifndef _terminal_hpp_
+#define _terminal_hpp_
+
+#include <thread>
+#include <atomic>
+#include <termios.h>
+#include "ring_buffer.hpp"
+
+#define TERM_OUT 0xFFFFFF00
+#define TERM_IN 0xFFFFFF04
+
+#define TERMINAL_BUFFER_SIZE 65536
+#define TERMINAL_POLL_CYCLES 65536 // guest cycles between checks for new input
+#define TERMINAL_POLL_MS 1 // how long the I/O thread waits for input before draining output again
+
+// Console device. A background thread reads stdin and writes stdout, the emulator only touches
+// the two ring buffers, so it never blocks on host I/O and output leaves in chunks.
+class Terminal {
+public:
+  Terminal();
+  ~Terminal();
+
+  void start();
+  void stop(); // flushes pending output
+
+  void write(unsigned char c);
+  bool read(unsigned char& c); // false if no input arrived
+
+private:
+  Terminal(const Terminal&) = delete;
+  Terminal& operator=(const Terminal&) = delete;
+
+  void run();
+  void drainOutput();
+
+  RingBuffer<unsigned char, TERMINAL_BUFFER_SIZE> input;
+  RingBuffer<unsigned char, TERMINAL_BUFFER_SIZE> output;
+  std::thread thread;
+  std::atomic<bool> running;
+  bool rawMode;
+  struct termios savedAttributes;
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef _thread_pool_hpp_
+#define _thread_pool_hpp_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Fixed set of tasks spread over per-worker queues. A worker takes from the back of its own
+// queue and, once that is empty, steals from the front of the others, so long tasks don't leave
+// the remaining workers idle.
+class ThreadPool {
+public:
+  ThreadPool(unsigned int threads); // 0 means one per core
+
+  void submit(std::function<void()> task);
+  void run(); // returns once every submitted task has finished, the pool can then be used again
+
+private:
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void work(unsigned int worker);
+  bool takeTask(unsigned int worker, std::function<void()>& task);
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  unsigned int nextQueue;
+  size_t submitted; // since the last run
+};
+
+#endif
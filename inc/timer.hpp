@@ -0,0 +1,30 @@
+#ifndef _timer_hpp_
+#define _timer_hpp_
+
+#define TIM_CFG 0xFFFFFF10
+
+#define GUEST_CYCLES_PER_MS 100000ULL // 100 MHz guest clock
+#define TIMER_PERIODS_NUM 8
+
+// Periodic timer counted in guest cycles, so interrupts land at the same point of every run.
+// It stays stopped until the guest writes tim_cfg, whose low 3 bits select the period.
+class Timer {
+public:
+  Timer();
+
+  void reset();
+  void configure(unsigned int value, unsigned long long now);
+
+  bool isExpired(unsigned long long now) const { return now >= deadline; }
+  unsigned long long getDeadline() const { return deadline; } // ~0 while stopped
+  void acknowledge(unsigned long long now); // moves the deadline past now
+
+  unsigned long long getPeriod() const { return period; }
+  void restore(unsigned long long period, unsigned long long deadline);
+
+private:
+  unsigned long long period;
+  unsigned long long deadline;
+};
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef _tracer_hpp_
+#define _tracer_hpp_
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include "ring_buffer.hpp"
+
+#define TRACE_MAGIC "EMUTRACE"
+
+#define TRACE_CHUNK_SIZE (256 * 1024)
+#define TRACE_CHUNKS 16 // the in-memory ring holds TRACE_CHUNKS * TRACE_CHUNK_SIZE bytes
+#define TRACE_MAX_RECORD 32 // upper bound of one encoded record
+#define TRACE_WORD_CACHE_BITS 12
+#define TRACE_WORD_CACHE_SIZE (1 << TRACE_WORD_CACHE_BITS)
+
+// TraceRecord.flags
+#define TRACE_REGISTER 0x1 // reg/value hold a register written by the instruction
+#define TRACE_LOAD 0x2 // address/data hold a memory read
+#define TRACE_STORE 0x4 // address/data hold a memory write
+// only in the encoded flags byte
+#define TRACE_SEQUENTIAL 0x8 // pc follows the previous one, not stored
+#define TRACE_CACHED_WORD 0x10 // word is the one last seen at this pc, not stored
+
+#define TRACE_REGISTERS_NUM 19 // 16 gp registers followed by the 3 CSRs
+
+struct TraceRecord {
+  unsigned int pc;
+  unsigned int word; // raw instruction
+  unsigned char flags;
+  unsigned char reg; // 0-15 gp register, 16-18 CSR
+  int value;
+  unsigned int address;
+  int data;
+};
+
+// Delta state shared by the encoder and the decoder. A record is a flags byte followed by
+// the PC as a zigzag varint delta from the previous PC + 4 unless sequential, the 4 bytes of the
+// instruction word unless it hits the word cache, the register number with a zigzag varint delta
+// from its last traced value, and the memory address as a zigzag varint delta from the previous
+// one followed by the data as a zigzag varint.
+struct TraceState {
+  unsigned int pc;
+  unsigned int address;
+  int registers[TRACE_REGISTERS_NUM];
+  unsigned int cachedPcs[TRACE_WORD_CACHE_SIZE]; // direct mapped, indexed by (pc >> 2)
+  unsigned int cachedWords[TRACE_WORD_CACHE_SIZE];
+
+  TraceState();
+};
+
+// Encodes one record per retired instruction into fixed-size chunks of an in-memory ring.
+// Full chunks are handed to a writer thread, which appends them to the trace file, and come back
+// once written; the emulator only waits when the writer falls a whole ring behind.
+class Tracer {
+public:
+  Tracer();
+  ~Tracer();
+
+  bool start(std::string file);
+  void stop();
+
+  void record(const TraceRecord& record);
+  unsigned long long getRecords() const { return records; }
+  unsigned long long getBytes() const { return bytes; }
+
+private:
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+  void submitChunk();
+  void run();
+
+  unsigned char* chunks;
+  RingBuffer<int, TRACE_CHUNKS> filledChunks; // emulator -> writer
+  RingBuffer<int, TRACE_CHUNKS> freeChunks; // writer -> emulator
+  unsigned int sizes[TRACE_CHUNKS];
+  int current; // chunk being filled
+  unsigned int position;
+  TraceState state;
+  unsigned long long records;
+  unsigned long long bytes;
+
+  FILE* output;
+  std::thread writer;
+  std::atomic<bool> running;
+};
+
+// Reads the records of a trace file back, in order.
+class TraceReader {
+public:
+  TraceReader();
+  ~TraceReader();
+
+  bool open(std::string file);
+  bool next(TraceRecord& record); // false at the end of the trace
+
+private:
+  TraceReader(const TraceReader&) = delete;
+  TraceReader& operator=(const TraceReader&) = delete;
+
+  bool readByte(unsigned char& b);
+  bool readVarint(unsigned int& value);
+
+  FILE* input;
+  TraceState state;
+};
+
+static inline unsigned char* putVarint(unsigned char* out, unsigned int value) {
+  if (value < 0x80) {
+    *out = value;
+    return out + 1;
+  }
+  while (value >= 0x80) {
+    *out++ = (value & 0x7f) | 0x80;
+    value >>= 7;
+  }
+  *out++ = value;
+  return out;
+}
+
+static inline unsigned int zigzag(int value) {
+  return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+}
+
+static inline int unzigzag(unsigned int value) {
+  return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+// All state is read before and updated after the bytes are written, the byte stores could
+// alias it otherwise and force the compiler to reload it after every one.
+inline void Tracer::record(const TraceRecord& record) {
+  if (position + TRACE_MAX_RECORD > TRACE_CHUNK_SIZE) submitChunk();
+
+  unsigned int line = (record.pc >> 2) & (TRACE_WORD_CACHE_SIZE - 1);
+  bool sequential = record.pc == state.pc + 4;
+  int pcDelta = record.pc - (state.pc + 4);
+  bool cached = state.cachedPcs[line] == record.pc && state.cachedWords[line] == record.word;
+  int valueDelta = (record.flags & TRACE_REGISTER) ? record.value - state.registers[record.reg] : 0;
+  int addressDelta = record.address - state.address;
+
+  unsigned char* start = chunks + (size_t)current * TRACE_CHUNK_SIZE + position;
+  unsigned char* out = start + 1;
+  if (!sequential) out = putVarint(out, zigzag(pcDelta));
+  if (!cached) {
+    memcpy(out, &record.word, sizeof(record.word));
+    out += sizeof(record.word);
+  }
+  if (record.flags & TRACE_REGISTER) {
+    *out++ = record.reg;
+    out = putVarint(out, zigzag(valueDelta));
+  }
+  if (record.flags & (TRACE_LOAD | TRACE_STORE)) {
+    out = putVarint(out, zigzag(addressDelta));
+    out = putVarint(out, zigzag(record.data));
+  }
+  *start = record.flags | (sequential ? TRACE_SEQUENTIAL : 0) | (cached ? TRACE_CACHED_WORD : 0);
+
+  state.pc = record.pc;
+  if (!cached) {
+    state.cachedPcs[line] = record.pc;
+    state.cachedWords[line] = record.word;
+  }
+  if (record.flags & TRACE_REGISTER) state.registers[record.reg] = record.value;
+  if (record.flags & (TRACE_LOAD | TRACE_STORE)) state.address = record.address;
+  position += out - start;
+  records++;
+}
+
+#endif
@@ -0,0 +1,207 @@
+#include "../inc/archive.hpp"
+#include "../inc/object_file.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+// Table entries as they are laid out in the archive, read with memcpy since they need not be aligned.
+struct MemberEntry {
+  unsigned int nameOffset; // in the name pool
+  unsigned int nameLength;
+  unsigned long long offset; // of the contents from the start of the archive
+  unsigned long long length;
+};
+
+struct IndexEntry {
+  unsigned int nameOffset;
+  unsigned int nameLength;
+  int member;
+};
+
+static IndexEntry indexEntry(const char* index, int k) {
+  IndexEntry entry;
+  memcpy(&entry, index + (size_t)k * sizeof(IndexEntry), sizeof(IndexEntry));
+  return entry;
+}
+
+static bool fitsIn(unsigned long long offset, unsigned long long length, size_t size) {
+  return offset <= size && length <= size - offset;
+}
+
+bool Archive::isArchive(const char* data, size_t size) {
+  return size >= sizeof(ARCHIVE_MAGIC) - 1 && memcmp(data, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC) - 1) == 0;
+}
+
+bool Archive::read(const char* data, size_t size) {
+  members.clear();
+  index = nullptr;
+  numOfSymbols = 0;
+  names = std::string_view();
+  error = "";
+
+  ByteReader reader(data, size);
+  std::string_view magic;
+  int numOfMembers = 0;
+  int numOfEntries = 0;
+  int namesSize = 0;
+  reader.readBytes(sizeof(ARCHIVE_MAGIC) - 1, magic);
+  reader.readInt(numOfMembers);
+  reader.readInt(numOfEntries);
+  reader.readInt(namesSize);
+  if (!reader.ok() || magic != ARCHIVE_MAGIC || numOfMembers < 0 || numOfEntries < 0 || namesSize < 0) {
+    error = "file is not an archive";
+    return false;
+  }
+
+  std::string_view memberTable;
+  std::string_view symbolTable;
+  std::string_view pool;
+  reader.readBytes((size_t)numOfMembers * sizeof(MemberEntry), memberTable);
+  reader.readBytes((size_t)numOfEntries * sizeof(IndexEntry), symbolTable);
+  reader.readBytes(namesSize, pool);
+  if (!reader.ok()) {
+    error = "archive is truncated";
+    return false;
+  }
+
+  for (int i = 0; i < numOfMembers; i++) {
+    MemberEntry entry;
+    memcpy(&entry, memberTable.data() + (size_t)i * sizeof(MemberEntry), sizeof(MemberEntry));
+    if (!fitsIn(entry.nameOffset, entry.nameLength, pool.size()) || !fitsIn(entry.offset, entry.length, size)) {
+      error = "member table points outside of the archive";
+      members.clear();
+      return false;
+    }
+    ArchiveMember member;
+    member.name = pool.substr(entry.nameOffset, entry.nameLength);
+    member.contents = std::string_view(data + entry.offset, entry.length);
+    members.push_back(member);
+  }
+
+  // only the index is checked here, members are parsed by whoever extracts them
+  std::string_view previous;
+  for (int k = 0; k < numOfEntries; k++) {
+    IndexEntry entry = indexEntry(symbolTable.data(), k);
+    if (!fitsIn(entry.nameOffset, entry.nameLength, pool.size()) || entry.member < 0 || entry.member >= numOfMembers) {
+      error = "symbol index points outside of the archive";
+      members.clear();
+      return false;
+    }
+    std::string_view name = pool.substr(entry.nameOffset, entry.nameLength);
+    if (k > 0 && !(previous < name)) {
+      error = "symbol index is not sorted";
+      members.clear();
+      return false;
+    }
+    previous = name;
+  }
+
+  index = symbolTable.data();
+  numOfSymbols = numOfEntries;
+  names = pool;
+  return true;
+}
+
+std::string_view Archive::symbolName(int k) const {
+  IndexEntry entry = indexEntry(index, k);
+  return names.substr(entry.nameOffset, entry.nameLength);
+}
+
+int Archive::symbolMember(int k) const {
+  return indexEntry(index, k).member;
+}
+
+int Archive::findSymbol(std::string_view name) const {
+  int low = 0;
+  int high = numOfSymbols;
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    if (symbolName(middle) < name) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if (low == numOfSymbols || symbolName(low) != name) return -1;
+  return symbolMember(low);
+}
+
+bool writeArchive(const std::string& file, const std::vector<std::string>& objectFiles, std::string& error) {
+  std::vector<std::unique_ptr<MappedFile>> mappedFiles;
+  std::vector<MemberEntry> memberTable;
+  std::vector<std::pair<std::string_view, int>> globals; // (name, member)
+  std::string pool;
+
+  for (int i = 0; i < objectFiles.size(); i++) {
+    const std::string& objectFile = objectFiles.at(i);
+    mappedFiles.emplace_back(new MappedFile());
+    MappedFile& mapped = *mappedFiles.back();
+    if (!mapped.open(objectFile)) {
+      error = "cannot open '" + objectFile + "'";
+      return false;
+    }
+
+    ObjectFile object;
+    if (!object.read(mapped.data(), mapped.size())) {
+      error = "'" + objectFile + "' is not an object file: " + object.getError();
+      return false;
+    }
+
+    // same rule as the linker's global symbol table
+    for (int j = 0; j < object.symbols.size(); j++) {
+      const ObjectSymbol& symbol = object.symbols.at(j);
+      if (symbol.isDefined && (symbol.isGlobal || symbol.isExtern)) globals.push_back(std::make_pair(symbol.name, i));
+    }
+
+    std::string name = objectFile.substr(objectFile.rfind('/') + 1);
+    MemberEntry entry = {(unsigned int)pool.size(), (unsigned int)name.size(), 0, mapped.size()};
+    memberTable.push_back(entry);
+    pool += name;
+  }
+
+  std::stable_sort(globals.begin(), globals.end(), [](const std::pair<std::string_view, int>& a, const std::pair<std::string_view, int>& b) {
+    return a.first < b.first;
+  });
+
+  std::vector<IndexEntry> symbolTable;
+  for (int k = 0; k < globals.size(); k++) {
+    if (k > 0 && globals.at(k).first == globals.at(k - 1).first) {
+      // a member defining a global twice is reported by the linker if the member is used
+      if (globals.at(k).second == globals.at(k - 1).second) continue;
+      error = "symbol '" + std::string(globals.at(k).first) + "' is defined in both '" + objectFiles.at(globals.at(k - 1).second)
+            + "' and '" + objectFiles.at(globals.at(k).second) + "'";
+      return false;
+    }
+    IndexEntry entry = {(unsigned int)pool.size(), (unsigned int)globals.at(k).first.size(), globals.at(k).second};
+    symbolTable.push_back(entry);
+    pool.append(globals.at(k).first);
+  }
+
+  unsigned long long offset = sizeof(ARCHIVE_MAGIC) - 1 + 3 * sizeof(int) + memberTable.size() * sizeof(MemberEntry)
+                            + symbolTable.size() * sizeof(IndexEntry) + pool.size();
+  for (int i = 0; i < memberTable.size(); i++) {
+    memberTable.at(i).offset = offset;
+    offset += memberTable.at(i).length;
+  }
+
+  std::ofstream output(file, std::ios::binary);
+  if (!output) {
+    error = "cannot create '" + file + "'";
+    return false;
+  }
+  int counts[3] = {(int)memberTable.size(), (int)symbolTable.size(), (int)pool.size()};
+  output.write(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC) - 1);
+  output.write((const char*)counts, sizeof(counts));
+  output.write((const char*)memberTable.data(), memberTable.size() * sizeof(MemberEntry));
+  output.write((const char*)symbolTable.data(), symbolTable.size() * sizeof(IndexEntry));
+  output.write(pool.data(), pool.size());
+  for (int i = 0; i < mappedFiles.size(); i++) {
+    output.write(mappedFiles.at(i)->data(), mappedFiles.at(i)->size());
+  }
+  if (!output) {
+    error = "cannot write '" + file + "'";
+    return false;
+  }
+  return true;
+}
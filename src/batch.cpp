@@ -0,0 +1,156 @@
+#include "../inc/batch.hpp"
+#include "../inc/thread_pool.hpp"
+#include <sstream>
+
+Batch::Batch(std::string listFile, unsigned int threads, std::string outputFile) {
+  this->listFile = listFile;
+  this->threads = threads;
+  this->outputFile = outputFile;
+}
+
+bool Batch::readList() {
+  std::ifstream input(listFile);
+  if (!input) return false;
+
+  std::string line;
+  while (std::getline(input, line)) {
+    size_t comment = line.find('#');
+    if (comment != std::string::npos) line.erase(comment);
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos) continue;
+    size_t last = line.find_last_not_of(" \t\r");
+
+    BatchResult result = BatchResult();
+    result.image = line.substr(first, last - first + 1);
+    results.push_back(result);
+  }
+  return true;
+}
+
+void Batch::runImage(BatchResult& result, std::function<void(Emulator&)>& configure) {
+  std::unique_ptr<Emulator> emulator(new Emulator());
+  configure(*emulator);
+  emulator->setConsole(false);
+  emulator->setInputFile(result.image);
+
+  result.status = emulator->run();
+  if (result.status == EMULATOR_LOAD_FAILED) return;
+
+  result.stopReason = emulator->getStopReason();
+  result.instructions = emulator->getRetiredInstructions();
+  result.cycles = emulator->getCycles();
+  for (int i = 0; i < GP_REGS_NUM; i++) result.gp_regs[i] = emulator->getRegister(i);
+  for (int i = 0; i < CS_REGS_NUM; i++) result.cs_regs[i] = emulator->getCsr(i);
+  result.memoryHash = emulator->memoryHash();
+}
+
+int Batch::run(std::function<void(Emulator&)> configure) {
+  if (!readList()) {
+    std::cout << "batch list '" << listFile << "' does not exist.\n";
+    return EMULATOR_LOAD_FAILED;
+  }
+
+  ThreadPool pool(threads);
+  for (int i = 0; i < results.size(); i++) {
+    BatchResult* result = &results.at(i);
+    pool.submit([this, result, &configure]() { runImage(*result, configure); });
+  }
+  pool.run();
+
+  std::ofstream output(outputFile, std::ios::out);
+  if (!output) {
+    std::cout << "could not open '" << outputFile << "'.\n";
+    return EMULATOR_LOAD_FAILED;
+  }
+  bool csv = outputFile.size() >= 4 && outputFile.compare(outputFile.size() - 4, 4, ".csv") == 0;
+  if (csv) writeCsv(output);
+  else writeJson(output);
+
+  int halted = 0, exhausted = 0, failed = 0;
+  for (int i = 0; i < results.size(); i++) {
+    int status = results.at(i).status;
+    if (status == EMULATOR_HALTED) halted++;
+    else if (status == EMULATOR_BUDGET_EXHAUSTED) exhausted++;
+    else failed++;
+  }
+  std::cout << std::dec << results.size() << " images: " << halted << " halted, " << exhausted
+            << " budget exhausted, " << failed << " failed to load\n";
+
+  if (failed != 0) return EMULATOR_LOAD_FAILED;
+  return exhausted != 0 ? EMULATOR_BUDGET_EXHAUSTED : EMULATOR_HALTED;
+}
+
+static std::string statusName(int status) {
+  if (status == EMULATOR_HALTED) return "halted";
+  if (status == EMULATOR_BUDGET_EXHAUSTED) return "budget exhausted";
+  return "load failed";
+}
+
+static std::string hexWord(unsigned int value) {
+  std::stringstream ss;
+  ss << "0x" << std::setw(8) << std::setfill('0') << std::hex << value;
+  return ss.str();
+}
+
+static std::string jsonString(const std::string& str) {
+  std::string escaped = "\"";
+  for (int i = 0; i < str.size(); i++) {
+    char c = str.at(i);
+    if (c == '"' || c == '\\') escaped += '\\';
+    if ((unsigned char)c < 0x20) {
+      escaped += ' ';
+      continue;
+    }
+    escaped += c;
+  }
+  return escaped + "\"";
+}
+
+// Quoted as in RFC 4180, a quote inside is doubled.
+static std::string csvField(const std::string& str) {
+  std::string quoted = "\"";
+  for (int i = 0; i < str.size(); i++) {
+    if (str.at(i) == '"') quoted += '"';
+    quoted += str.at(i);
+  }
+  return quoted + "\"";
+}
+
+void Batch::writeJson(std::ostream& out) {
+  out << "[\n";
+  for (int i = 0; i < results.size(); i++) {
+    BatchResult& result = results.at(i);
+    out << "  {\"image\": " << jsonString(result.image) << ", \"status\": \"" << statusName(result.status) << "\"";
+    if (result.status != EMULATOR_LOAD_FAILED) {
+      if (result.status == EMULATOR_BUDGET_EXHAUSTED) out << ", \"budget\": \"" << result.stopReason << "\"";
+      out << ", \"instructions\": " << std::dec << result.instructions << ", \"cycles\": " << result.cycles;
+      out << ", \"registers\": [";
+      for (int j = 0; j < GP_REGS_NUM; j++) out << (j == 0 ? "" : ", ") << "\"" << hexWord(result.gp_regs[j]) << "\"";
+      out << "], \"csr\": [";
+      for (int j = 0; j < CS_REGS_NUM; j++) out << (j == 0 ? "" : ", ") << "\"" << hexWord(result.cs_regs[j]) << "\"";
+      out << "], \"memory_hash\": \"0x" << std::setw(16) << std::setfill('0') << std::hex << result.memoryHash << "\"";
+    }
+    out << "}" << (i + 1 == results.size() ? "" : ",") << "\n";
+  }
+  out << "]\n";
+}
+
+void Batch::writeCsv(std::ostream& out) {
+  out << "image,status,instructions,cycles";
+  for (int j = 0; j < GP_REGS_NUM; j++) out << ",r" << std::dec << j;
+  out << ",status_csr,handler_csr,cause_csr,memory_hash\n";
+
+  for (int i = 0; i < results.size(); i++) {
+    BatchResult& result = results.at(i);
+    std::string status = statusName(result.status);
+    if (result.status == EMULATOR_BUDGET_EXHAUSTED) status = result.stopReason + " budget exhausted";
+    out << csvField(result.image) << "," << status;
+    if (result.status != EMULATOR_LOAD_FAILED) {
+      out << "," << std::dec << result.instructions << "," << result.cycles;
+      for (int j = 0; j < GP_REGS_NUM; j++) out << "," << hexWord(result.gp_regs[j]);
+      for (int j = 0; j < CS_REGS_NUM; j++) out << "," << hexWord(result.cs_regs[j]);
+      out << ",0x" << std::setw(16) << std::setfill('0') << std::hex << result.memoryHash;
+    }
+    out << "\n";
+  }
+}
@@ -1,38 +1,219 @@
 #include "../inc/emulator.hpp"
+#include "../inc/object_file.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
 
 Emulator::Emulator() {
   inputFileStr = "";
-  nextInstruction = {(OP_CODES)0,0,0,0,0};
-  gp_regs = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0x40000000};
-  cs_regs = {0,0,0};
+  symbolFileStr = "";
+  mapFileStr = "";
+  hasMap = false;
+  traceFileStr = "";
+  recordFileStr = "";
+  replayFileStr = "";
+  gdbAddressStr = "";
+  traceAccess = 0;
+  restoreFileStr = "";
+  saveFileStr = "";
+  snapshotSize = 0;
+  instructionCache.resize(INSTRUCTION_CACHE_SIZE);
+  console = true;
+  jitPassed = true;
+  stats = false;
+  blockStats = false;
+  startupMicroseconds = 0;
+  executionMicroseconds = 0;
+  maxInstructions = 0;
+  maxCycles = 0;
+  maxMilliseconds = 0;
+  jitEnabled = false;
+  jitVerify = false;
+  jitThreshold = JIT_THRESHOLD;
+  reset();
+}
+
+Emulator::~Emulator() {
+  memory.clear();
+  unmapFiles();
+}
+
+// Puts the machine back into its power-on state, with empty memory.
+void Emulator::reset() {
+  for (int i = 0; i < GP_REGS_NUM; i++) gp_regs[i] = 0;
+  for (int i = 0; i < CS_REGS_NUM; i++) cs_regs[i] = 0;
+  gp_regs[PC] = 0x40000000;
+  memory.clear();
+  unmapFiles();
+  for (int i = 0; i < INSTRUCTION_CACHE_SIZE; i++) instructionCache[i].valid = false;
+  flushBlocks();
+  if (profiler) profiler->clear();
+  timer.reset();
+  timerPending = false;
+  terminalPending = false;
+  nextTerminalPoll = TERMINAL_POLL_CYCLES;
+  blocksTranslated = 0;
+  blocksCompiled = 0;
+  retiredInstructions = 0;
+  cycles = 0;
+  stopReason = "";
   badInstruction = false;
   halted = false;
+  tracing = false;
+  events.clear();
+  recording = false;
+  replaying = false;
+  replayStopped = false;
+  nextEvent = 0;
+  debugStop = ~0ULL;
+  breakpointHit = false;
 }
 
+// The file is mapped privately, so segment bytes are only copied for partially covered pages
+// and guest stores into the image get their own copy of the page.
 bool Emulator::readInputFile() {
-  std::ifstream inputFile(inputFileStr, std::ios::in | std::ios::binary);
-  if (!inputFile) return false;
-  
-  int numOfEntries;
-  inputFile.read((char*)&numOfEntries, sizeof(int));
-
-  for (int i = 0; i < numOfEntries; i++) {
-    int address;
-    int len;
-    std::string str;
-
-    inputFile.read((char*)&address, sizeof(int));
-    inputFile.read((char*)&len, sizeof(int));
-    str.resize(len);
-    inputFile.read((char*)str.c_str(), len);
-    
-    for (int j = 0; j < str.size(); j++) {
-      char c = str.at(j);
-      memory[address++] = c;
-    }
+  int fd = open(inputFileStr.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat info;
+  if (fstat(fd, &info) < 0) {
+    close(fd);
+    return false;
+  }
+  if ((size_t)info.st_size < sizeof(int)) {
+    close(fd); // nothing to load
+    return true;
+  }
+
+  unsigned char* image = mapFile(fd, info.st_size);
+  close(fd);
+  if (image == nullptr) return false;
+
+  std::vector<ImageSegment> segments;
+  if (!readImageSegments((const char*)image, info.st_size, segments)) return false;
+  for (int i = 0; i < segments.size(); i++) {
+    memory.load(segments.at(i).address, image + segments.at(i).offset, segments.at(i).length);
+  }
+
+  return true;
+}
+
+// Private mapping that backs guest pages until the next reset.
+unsigned char* Emulator::mapFile(int fd, size_t size) {
+  void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  if (mapping == MAP_FAILED) return nullptr;
+  mappings.push_back(std::make_pair((unsigned char*)mapping, size));
+  return (unsigned char*)mapping;
+}
+
+void Emulator::unmapFiles() {
+  for (int i = 0; i < mappings.size(); i++) munmap(mappings.at(i).first, mappings.at(i).second);
+  mappings.clear();
+}
+
+// Written beside the target and renamed over it, the target may be the restored snapshot that is
+// still mapped, and a failed save keeps the old one.
+bool Emulator::saveSnapshot(std::string file) {
+  std::string temporary = file + ".tmp";
+  int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) return false;
+  bool written = writeSnapshot(fd) && fsync(fd) == 0;
+  written &= close(fd) == 0;
+  if (written && rename(temporary.c_str(), file.c_str()) == 0) return true;
+  unlink(temporary.c_str());
+  return false;
+}
+
+bool Emulator::restoreSnapshot(std::string file) {
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  bool restored = mapSnapshot(fd);
+  close(fd);
+  return restored;
+}
+
+// Returns nullptr if the snapshot could not be written.
+std::unique_ptr<Snapshot> Emulator::takeSnapshot() {
+  std::unique_ptr<Snapshot> snapshot(new Snapshot());
+  if (!snapshot->isValid() || !writeSnapshot(snapshot->getFd())) return nullptr;
+  snapshot->setSize(snapshotSize);
+  return snapshot;
+}
+
+bool Emulator::restoreSnapshot(const Snapshot& snapshot) {
+  return mapSnapshot(snapshot.getFd());
+}
+
+bool Emulator::writeSnapshot(int fd) {
+  std::vector<SnapshotPage> table;
+  std::vector<const unsigned char*> contents;
+  memory.forEachPage([&](unsigned int address, const Page& page) {
+    SnapshotPage entry;
+    entry.address = address;
+    memcpy(entry.written, page.written, sizeof(entry.written));
+    table.push_back(entry);
+    contents.push_back(page.data);
+  });
+
+  SnapshotHeader header = SnapshotHeader();
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.pages = table.size();
+  memcpy(header.gp_regs, gp_regs, sizeof(gp_regs));
+  memcpy(header.cs_regs, cs_regs, sizeof(cs_regs));
+  header.retiredInstructions = retiredInstructions;
+  header.cycles = cycles;
+  header.timerPeriod = timer.getPeriod();
+  header.timerDeadline = timer.getDeadline();
+  header.nextTerminalPoll = nextTerminalPoll;
+  header.timerPending = timerPending;
+  header.terminalPending = terminalPending;
+
+  std::vector<unsigned char> head(snapshotDataOffset(header.pages), 0);
+  memcpy(head.data(), &header, sizeof(header));
+  if (!table.empty()) memcpy(head.data() + sizeof(header), table.data(), table.size() * sizeof(SnapshotPage));
+  if (!writeAll(fd, head.data(), head.size())) return false;
+  for (int i = 0; i < contents.size(); i++) {
+    if (!writeAll(fd, contents.at(i), GUEST_PAGE_SIZE)) return false;
+  }
+
+  snapshotSize = head.size() + contents.size() * GUEST_PAGE_SIZE;
+  return true;
+}
+
+// Puts the machine into the state stored in fd, whose pages become copy-on-write views of it.
+bool Emulator::mapSnapshot(int fd) {
+  struct stat info;
+  if (fstat(fd, &info) < 0 || (size_t)info.st_size < sizeof(SnapshotHeader)) return false;
+
+  SnapshotHeader header;
+  if (pread(fd, &header, sizeof(header), 0) != sizeof(header)) return false;
+  if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) return false;
+  size_t dataOffset = snapshotDataOffset(header.pages);
+  if ((size_t)info.st_size != dataOffset + (size_t)header.pages * GUEST_PAGE_SIZE) return false;
+
+  reset();
+  unsigned char* snapshot = mapFile(fd, info.st_size);
+  if (snapshot == nullptr) return false;
+
+  const SnapshotPage* table = (const SnapshotPage*)(snapshot + sizeof(SnapshotHeader));
+  for (unsigned int i = 0; i < header.pages; i++) {
+    memory.mapPage(table[i].address, snapshot + dataOffset + (size_t)i * GUEST_PAGE_SIZE, table[i].written);
   }
-  
-  inputFile.close();
+
+  memcpy(gp_regs, header.gp_regs, sizeof(gp_regs));
+  memcpy(cs_regs, header.cs_regs, sizeof(cs_regs));
+  retiredInstructions = header.retiredInstructions;
+  cycles = header.cycles;
+  timer.restore(header.timerPeriod, header.timerDeadline);
+  nextTerminalPoll = header.nextTerminalPoll;
+  timerPending = header.timerPending;
+  terminalPending = header.terminalPending;
+  snapshotSize = info.st_size;
   return true;
 }
 
@@ -41,8 +222,8 @@ void Emulator::printRegisters() {
   std::cout << "Emulated processor state:\n";
   int counter = 0;
 
-  for (int i = 0; i < gp_regs.size(); i++) {
-    std::cout << "r" << std::dec << i << "=0x" << std::setw(8) << std::setfill('0') << std::hex << gp_regs.at(i);
+  for (int i = 0; i < GP_REGS_NUM; i++) {
+    std::cout << "r" << std::dec << i << "=0x" << std::setw(8) << std::setfill('0') << std::hex << gp_regs[i];
     counter++;
 
     if (counter % 4 == 0) {
@@ -52,195 +233,910 @@ void Emulator::printRegisters() {
       std::cout << " ";
     }
   }
+
+  if (!hasMap) return;
+  // registers holding addresses inside the program, pc first
+  for (int k = 0; k < GP_REGS_NUM; k++) {
+    int i = k == 0 ? PC : k - 1;
+    if (!symbolMap.inSection(gp_regs[i])) continue;
+    std::cout << "r" << std::dec << i << (i == PC ? " (pc)" : "") << " -> " << symbolMap.location(gp_regs[i]) << "\n";
+  }
+}
+
+std::string Emulator::describeAddress(unsigned int address) {
+  std::stringstream ss;
+  ss << "0x" << std::setw(8) << std::setfill('0') << std::hex << address;
+  if (hasMap && symbolMap.inSection(address)) ss << " (" << symbolMap.location(address) << ")";
+  return ss.str();
+}
+
+static HANDLER_ID handlerForOpCode(unsigned char code) {
+  switch (code) {
+    case OP_CODES::HALT: return H_HALT;
+    case OP_CODES::INT: return H_INT;
+    case OP_CODES::CALL_MEM_A_B_D: return H_CALL_MEM_A_B_D;
+    case OP_CODES::XCHG: return H_XCHG;
+    case OP_CODES::PUSH: return H_PUSH;
+    case OP_CODES::POP: return H_POP;
+    case OP_CODES::CSR_WR_MEM_UPDATE: return H_CSR_WR_MEM_UPDATE;
+    case OP_CODES::ADD: return H_ADD;
+    case OP_CODES::SUB: return H_SUB;
+    case OP_CODES::MUL: return H_MUL;
+    case OP_CODES::DIV: return H_DIV;
+    case OP_CODES::NOT: return H_NOT;
+    case OP_CODES::AND: return H_AND;
+    case OP_CODES::OR: return H_OR;
+    case OP_CODES::XOR: return H_XOR;
+    case OP_CODES::SHL: return H_SHL;
+    case OP_CODES::SHR: return H_SHR;
+    case OP_CODES::CSRRD: return H_CSRRD;
+    case OP_CODES::CSRWR: return H_CSRWR;
+    case OP_CODES::LD_B_D: return H_LD_B_D;
+    case OP_CODES::LD_MEM_B_C_D: return H_LD_MEM_B_C_D;
+    case OP_CODES::ST_MEM: return H_ST_MEM;
+    case OP_CODES::ST_MEM_MEM: return H_ST_MEM_MEM;
+    case OP_CODES::JMP_MEM_A_D: return H_JMP_MEM_A_D;
+    case OP_CODES::BEQ_MEM_A_D: return H_BEQ_MEM_A_D;
+    case OP_CODES::BNE_MEM_A_D: return H_BNE_MEM_A_D;
+    case OP_CODES::BGT_MEM_A_D: return H_BGT_MEM_A_D;
+    default: return H_BAD_INSTRUCTION;
+  }
 }
 
-void Emulator::fetchInstruction() {
+void Emulator::decodeInstruction(DecodedInstruction& entry, unsigned int pc) {
+  unsigned int word = memory.readWord(pc);
+  memory.markCode(pc); // so that writes over this instruction invalidate the entry
+
   unsigned char first, second, third, fourth;
+  fourth = word & 0b11111111;
+  third = (word >> 8) & 0b11111111;
+  second = (word >> 16) & 0b11111111;
+  first = (word >> 24) & 0b11111111;
+
+  entry.pc = pc;
+  entry.valid = true;
+  entry.handler = handlerForOpCode(first);
+  entry.instruction.M = (OP_CODES)first;
+  entry.instruction.A = (second >> 4 ) & 15;
+  entry.instruction.B = second & 15;
+  entry.instruction.C = (third >> 4) & 15;
+  entry.instruction.D = ((third & 15) << 8) | fourth;
+  if (!breakpoints.empty() && breakpoints.count(pc) != 0) entry.handler = H_BREAKPOINT;
+}
+
+const DecodedInstruction& Emulator::fetchInstruction(unsigned int pc) {
+  DecodedInstruction& entry = instructionCache[(pc >> 2) & (INSTRUCTION_CACHE_SIZE - 1)];
+  if (!entry.valid || entry.pc != pc) decodeInstruction(entry, pc);
+  return entry;
+}
+
+// Drops cached decodings of every instruction overlapping the 4 bytes written at address.
+void Emulator::invalidateInstructions(unsigned int address) {
+  for (unsigned int pc = address - 3; pc != address + 4; pc++) {
+    DecodedInstruction& entry = instructionCache[(pc >> 2) & (INSTRUCTION_CACHE_SIZE - 1)];
+    if (entry.pc == pc) entry.valid = false;
+  }
+}
+
+// Breakpoints patch the decoded instruction, so execution pays nothing for them until it reaches one.
+// Translated blocks hold copies of the decodings and have to go.
+void Emulator::setBreakpoint(unsigned int address, bool enabled) {
+  if (enabled) breakpoints.insert(address);
+  else breakpoints.erase(address);
+
+  DecodedInstruction& entry = instructionCache[(address >> 2) & (INSTRUCTION_CACHE_SIZE - 1)];
+  if (entry.valid && entry.pc == address) {
+    entry.handler = enabled ? H_BREAKPOINT : handlerForOpCode(entry.instruction.M);
+  }
+  flushBlocks();
+}
+
+// Debugger writes go straight to memory, devices don't see them.
+void Emulator::writeDebugByte(unsigned int address, unsigned char value) {
+  if (memory.writeByte(address, value)) {
+    invalidateInstructions(address);
+    flushBlocks();
+  }
+}
+
+static bool isBlockTerminator(HANDLER_ID handler) {
+  return handler == H_HALT || handler == H_INT || handler == H_CALL_MEM_A_B_D || handler == H_JMP_MEM_A_D
+      || handler == H_BEQ_MEM_A_D || handler == H_BNE_MEM_A_D || handler == H_BGT_MEM_A_D
+      || handler == H_BAD_INSTRUCTION;
+}
+
+static bool writesPc(HANDLER_ID handler, const Instruction& in) {
+  switch (handler) {
+    case H_POP: return in.A == PC || in.B == PC;
+    case H_CSR_WR_MEM_UPDATE: return in.B == PC;
+    case H_XCHG: return in.B == PC || in.C == PC;
+    case H_PUSH: return in.A == PC;
+    case H_ADD: case H_SUB: case H_MUL: case H_DIV: case H_NOT: case H_AND: case H_OR: case H_XOR:
+    case H_SHL: case H_SHR: case H_CSRRD: case H_LD_B_D: case H_LD_MEM_B_C_D:
+      return in.A == PC;
+    default: return false;
+  }
+}
+
+// Instructions with A == 0 that only write gp_regs[A] do nothing.
+static bool isNop(HANDLER_ID handler, const Instruction& in) {
+  switch (handler) {
+    case H_ADD: case H_SUB: case H_MUL: case H_DIV: case H_NOT: case H_AND: case H_OR: case H_XOR:
+    case H_SHL: case H_SHR: case H_CSRRD: case H_LD_B_D: case H_LD_MEM_B_C_D:
+      return in.A == 0;
+    default: return false;
+  }
+}
+
+static int pushDisplacement(unsigned int d) {
+  // displacements above 255 are negative 12-bit values
+  return d > 255 ? (int)(d | 0xfffff000) : (int)d;
+}
 
-  unsigned int pc = gp_regs[PC]++;
-  auto it = memory.find(pc);
-  if (it == memory.end()) fourth = 0x00;
-  else fourth = it->second;
+// Guest cycle cost of an instruction: one cycle plus one for every data memory access.
+static unsigned int cyclesFor(HANDLER_ID handler) {
+  switch (handler) {
+    case H_INT: case H_CALL_MEM_A_B_D: case H_ST_MEM_MEM: return 3;
+    case H_PUSH: case H_POP: case H_CSR_WR_MEM_UPDATE: case H_LD_MEM_B_C_D: case H_ST_MEM:
+    case H_JMP_MEM_A_D: case H_BEQ_MEM_A_D: case H_BNE_MEM_A_D: case H_BGT_MEM_A_D: case H_LD_LITERAL:
+      return 2;
+    default: return 1;
+  }
+}
+
+Block* Emulator::translateBlock(unsigned int pc, unsigned int maxInstructions) {
+  Block* block = new Block();
+  block->startPc = pc;
+  block->successors[0] = nullptr;
+  block->successors[1] = nullptr;
+  block->native = nullptr;
+  block->executions = 0;
+  block->retired = 0;
+
+  unsigned int count = 0;
+  unsigned int cycles = 0;
+  while (true) {
+    const DecodedInstruction& entry = fetchInstruction(pc);
+    if (entry.handler == H_BREAKPOINT) {
+      // not executed and not retired, execution resumes at pc
+      MicroOp trap = {H_BREAKPOINT, 0, 0, 0, pc, 0, pc, count, cycles};
+      block->ops.push_back(trap);
+      break;
+    }
+    Instruction in = entry.instruction;
+    HANDLER_ID handler = entry.handler;
+    count++;
+    if (profiler) block->opcodes.push_back(in.M);
+    if (tracing) block->words.push_back(memory.readWord(pc));
+    cycles += cyclesFor(handler);
+
+    MicroOp op = {handler, in.A, in.B, in.C, in.D, 0, pc + 4, count, cycles};
+
+    if (isBlockTerminator(handler)) {
+      block->ops.push_back(op);
+      break;
+    }
+
+    if (handler == H_PUSH) op.d = pushDisplacement(in.D);
+
+    if (handler == H_LD_MEM_B_C_D && in.B == PC && in.C != PC && in.A != 0) {
+      // literal pool load, "ld $x, %rA"
+      op.handler = H_LD_LITERAL;
+      op.d = pc + 4 + in.D;
+
+      if (count < maxInstructions && in.A != PC) {
+        const DecodedInstruction& next = fetchInstruction(pc + 4);
+        if (next.handler == H_PUSH && next.instruction.C == in.A && next.instruction.A != PC && next.instruction.A != in.A) {
+          // followed by "push %rA"
+          count++;
+          if (profiler) block->opcodes.push_back(next.instruction.M);
+          if (tracing) block->words.push_back(memory.readWord(pc + 4));
+          cycles += cyclesFor(H_PUSH);
+          pc += 4;
+          op.handler = H_LD_LITERAL_PUSH;
+          op.b = next.instruction.A;
+          op.e = pushDisplacement(next.instruction.D);
+          op.nextPc = pc + 4;
+          op.retired = count;
+          op.cycles = cycles;
+        }
+      }
+    } else if (isNop(handler, in)) {
+      op.handler = H_EXIT; // placeholder, not emitted
+    } else if (in.A == PC || in.B == PC || in.C == PC) {
+      MicroOp sync = {H_SYNC_PC, 0, 0, 0, 0, 0, pc + 4, count - 1, cycles - cyclesFor(handler)};
+      block->ops.push_back(sync);
+    }
+
+    if (op.handler != H_EXIT) block->ops.push_back(op);
+
+    if (writesPc(handler, in)) {
+      MicroOp exit = {H_EXIT_DYNAMIC, 0, 0, 0, 0, 0, pc + 4, count, cycles};
+      block->ops.push_back(exit);
+      break;
+    }
+
+    pc += 4;
+    if (count >= maxInstructions) {
+      MicroOp exit = {H_EXIT, 0, 0, 0, 0, 0, pc, count, cycles};
+      block->ops.push_back(exit);
+      break;
+    }
+  }
+
+  block->instructions = count;
+  if (profiler) block->profile.assign(count + 1, 0);
+  blocksTranslated++;
+  return block;
+}
+
+Block* Emulator::findBlock(unsigned int pc) {
+  auto it = blocks.find(pc);
+  if (it != blocks.end()) return it->second.get();
+
+  Block* block = translateBlock(pc, MAX_BLOCK_INSTRUCTIONS);
+  blocks[pc] = std::unique_ptr<Block>(block);
+  return block;
+}
+
+void Emulator::flushBlocks() {
+  if (profiler) {
+    for (auto it = blocks.begin(); it != blocks.end(); it++) profiler->foldBlock(it->second.get());
+  }
+  blocks.clear();
+  jit.reset();
+  codeModified = false;
+}
+
+// Compiles a hot block, unless it has to stay interpreted or lies on a page whose code was overwritten.
+void Emulator::compileBlock(Block* block) {
+  if (!Jit::canCompile(block)) return;
+  unsigned int lastPc = block->ops.back().nextPc - 1;
+  for (unsigned int page = block->startPc & ~(GUEST_PAGE_SIZE - 1); ; page += GUEST_PAGE_SIZE) {
+    if (memory.isCodeWritten(page)) return;
+    if (page == (lastPc & ~(GUEST_PAGE_SIZE - 1))) break;
+  }
+
+  block->native = jit.compile(block);
+  if (block->native == nullptr) {
+    // buffer is full, start over with an empty one
+    for (auto it = blocks.begin(); it != blocks.end(); it++) it->second->native = nullptr;
+    jit.reset();
+    block->native = jit.compile(block);
+  }
+  if (block->native != nullptr) blocksCompiled++;
+}
+
+int Emulator::jitReadFourBytes(Emulator* emulator, unsigned int address) {
+  return emulator->readFourBytes(address);
+}
+
+int Emulator::jitWriteFourBytes(Emulator* emulator, int data, unsigned int address) {
+  emulator->writeFourBytes(data, address);
+  return emulator->codeModified;
+}
 
-  pc = gp_regs[PC]++;
-  it = memory.find(pc);
-  if (it == memory.end()) third = 0x00;
-  else third = it->second;
+inline int Emulator::traceRead(unsigned int address) {
+  int data = readFourBytes(address);
+  traceAccess |= TRACE_LOAD;
+  traceLoadAddress = address;
+  traceLoadData = data;
+  return data;
+}
 
-  pc = gp_regs[PC]++;
-  it = memory.find(pc);
-  if (it == memory.end()) second = 0x00;
-  else second = it->second;
+inline void Emulator::traceWrite(int data, unsigned int address) {
+  writeFourBytes(data, address);
+  traceAccess |= TRACE_STORE;
+  traceStoreAddress = address;
+  traceStoreData = data;
+}
 
-  pc = gp_regs[PC]++;
-  it = memory.find(pc);
-  if (it == memory.end()) first = 0x00;
-  else first = it->second;
+// Register an op leaves its result in, -1 if it writes none. CSRs follow the 16 gp registers.
+// The SP update of push and pop and the second register of xchg are not recorded.
+static int tracedRegister(const MicroOp* op) {
+  switch (op->handler) {
+    case H_ADD: case H_SUB: case H_MUL: case H_DIV: case H_NOT: case H_AND: case H_OR: case H_XOR:
+    case H_SHL: case H_SHR: case H_CSRRD: case H_LD_B_D: case H_LD_MEM_B_C_D: case H_LD_LITERAL:
+    case H_POP: case H_PUSH:
+      return op->a;
+    case H_XCHG: case H_LD_LITERAL_PUSH:
+      return op->b;
+    case H_CSRWR: case H_CSR_WR_MEM_UPDATE:
+      return GP_REGS_NUM + op->a;
+    case H_INT: case H_CALL_MEM_A_B_D: case H_JMP_MEM_A_D: case H_BEQ_MEM_A_D: case H_BNE_MEM_A_D: case H_BGT_MEM_A_D:
+      return PC;
+    default:
+      return -1;
+  }
+}
 
+// Emits one record for every instruction the op retired: the elided nops folded into it first,
+// then the op's own instruction(s) with the register written and the memory access made.
+// Instructions of a block are contiguous, the i-th one sits at startPc + 4 * i.
+inline void Emulator::traceOp(const Block* block, const MicroOp* op) {
+  unsigned int previous = op == block->ops.data() ? 0 : (op - 1)->retired;
+  unsigned int count = op->retired - previous;
+  bool own = op->handler != H_SYNC_PC && op->handler != H_EXIT && op->handler != H_EXIT_DYNAMIC;
 
-  nextInstruction.M = (OP_CODES)first;
-	nextInstruction.A = (second >> 4 ) & 15;
-	nextInstruction.B = second & 15;
-	nextInstruction.C = (third >> 4) & 15;
-	nextInstruction.D = ((third & 15) << 8) | fourth;
+  TraceRecord record;
+  for (unsigned int k = 0; k < count; k++) {
+    record.pc = block->startPc + 4 * (previous + k);
+    record.word = block->words[previous + k];
+    record.flags = 0;
 
+    if (own && op->handler == H_LD_LITERAL_PUSH && k == count - 2) {
+      // load half of the fused pair
+      record.flags = TRACE_REGISTER | (traceAccess & TRACE_LOAD);
+      record.reg = op->a;
+      record.value = gp_regs[op->a];
+      record.address = traceLoadAddress;
+      record.data = traceLoadData;
+    } else if (own && k == count - 1) {
+      int reg = op->handler == H_LD_LITERAL_PUSH ? op->b : tracedRegister(op);
+      if (reg >= 0) {
+        record.flags |= TRACE_REGISTER;
+        record.reg = reg;
+        record.value = reg < GP_REGS_NUM ? gp_regs[reg] : cs_regs[reg - GP_REGS_NUM];
+      }
+      // a store says more than the load it may depend on
+      if (traceAccess & TRACE_STORE) {
+        record.flags |= TRACE_STORE;
+        record.address = traceStoreAddress;
+        record.data = traceStoreData;
+      } else if ((traceAccess & TRACE_LOAD) && op->handler != H_LD_LITERAL_PUSH) {
+        record.flags |= TRACE_LOAD;
+        record.address = traceLoadAddress;
+        record.data = traceLoadData;
+      }
+    }
+    tracer->record(record);
+  }
+  traceAccess = 0;
 }
 
-void Emulator::executeInstruction() {
-  if (nextInstruction.M == OP_CODES::HALT) {
+// Block executor: with GCC every micro-op jumps straight to the next one through a table
+// of label addresses, otherwise a dense switch over HANDLER_ID is used.
+// Returns (index of the op the block was left at << 1) | exit taken, where exit 0 is a control
+// transfer and 1 is falling through. The TRACE instantiation records every retired instruction.
+#if defined(__GNUC__)
+#define HANDLER_CASE(id) L_##id:
+#define NEXT_OP { if (TRACE) traceOp(block, op); op++; goto *jumpTable[op->handler]; }
+#else
+#define HANDLER_CASE(id) case id:
+#define NEXT_OP { if (TRACE) traceOp(block, op); op++; goto dispatch; }
+#endif
+#define EXIT_BLOCK(slot) { if (TRACE) traceOp(block, op); return ((op - block->ops.data()) << 1) | slot; }
+// while tracing, memory accesses are captured for the record of the current op
+#define READ(address) (TRACE ? traceRead(address) : readFourBytes(address))
+#define WRITE(data, address) { if (TRACE) traceWrite(data, address); else writeFourBytes(data, address); }
+#define CHECK_CODE_MODIFIED if (codeModified) { gp_regs[PC] = op->nextPc; EXIT_BLOCK(1) }
+
+template <bool TRACE>
+unsigned int Emulator::runBlock(Block* block) {
+#if defined(__GNUC__)
+  static const void* jumpTable[HANDLERS_NUM] = {
+    &&L_H_HALT, &&L_H_INT, &&L_H_CALL_MEM_A_B_D, &&L_H_XCHG, &&L_H_PUSH, &&L_H_POP, &&L_H_CSR_WR_MEM_UPDATE,
+    &&L_H_ADD, &&L_H_SUB, &&L_H_MUL, &&L_H_DIV, &&L_H_NOT, &&L_H_AND, &&L_H_OR, &&L_H_XOR, &&L_H_SHL, &&L_H_SHR,
+    &&L_H_CSRRD, &&L_H_CSRWR, &&L_H_LD_B_D, &&L_H_LD_MEM_B_C_D, &&L_H_ST_MEM, &&L_H_ST_MEM_MEM,
+    &&L_H_JMP_MEM_A_D, &&L_H_BEQ_MEM_A_D, &&L_H_BNE_MEM_A_D, &&L_H_BGT_MEM_A_D, &&L_H_BAD_INSTRUCTION,
+    &&L_H_LD_LITERAL, &&L_H_LD_LITERAL_PUSH, &&L_H_SYNC_PC, &&L_H_EXIT, &&L_H_EXIT_DYNAMIC,
+    &&L_H_BREAKPOINT
+  };
+#endif
+
+  const MicroOp* op = block->ops.data();
+
+#if defined(__GNUC__)
+  goto *jumpTable[op->handler];
+#else
+dispatch:
+  switch (op->handler)
+#endif
+  {
+  HANDLER_CASE(H_HALT)
+    gp_regs[PC] = op->nextPc;
     halted = true;
-  } else if (nextInstruction.M == OP_CODES::INT) {
-    gp_regs[SP] -= 4;
-    writeFourBytes(gp_regs[PC], gp_regs[SP]);
+    EXIT_BLOCK(1)
+  HANDLER_CASE(H_INT)
+    gp_regs[PC] = op->nextPc;
+    raiseInterrupt(CAUSE_SOFTWARE);
+    EXIT_BLOCK(0)
+  HANDLER_CASE(H_CALL_MEM_A_B_D)
+    gp_regs[PC] = op->nextPc;
     gp_regs[SP] -= 4;
-    writeFourBytes(cs_regs[STATUS], gp_regs[SP]);
-    cs_regs[CAUSE] = 0x4;
-    cs_regs[STATUS] = cs_regs[STATUS] & (~0x1);
-    gp_regs[PC] = cs_regs[HANDLER];
-  } else if (nextInstruction.M == OP_CODES::CALL_MEM_A_B_D) {
-    gp_regs[SP] -= 4;
-    writeFourBytes(gp_regs[PC], gp_regs[SP]);
-    gp_regs[PC] = readFourBytes(gp_regs[nextInstruction.A] + gp_regs[nextInstruction.B] + nextInstruction.D);
-  } else if (nextInstruction.M == OP_CODES::XCHG) {
-    int temp = gp_regs[nextInstruction.B];
-    gp_regs[nextInstruction.B] = gp_regs[nextInstruction.C];
-    gp_regs[nextInstruction.C] = temp;
-  } else if (nextInstruction.M == OP_CODES::PUSH) {
-    if (nextInstruction.D > 255) {
-      // drugi komplement i oduzimaj
-      nextInstruction.D = nextInstruction.D | 0xfffff000;
-      nextInstruction.D = ~nextInstruction.D + 1;
-      gp_regs[nextInstruction.A] = gp_regs[nextInstruction.A] - nextInstruction.D;
-    } else {
-      gp_regs[nextInstruction.A] = gp_regs[nextInstruction.A] + nextInstruction.D;
+    WRITE(gp_regs[PC], gp_regs[SP]);
+    gp_regs[PC] = READ(gp_regs[op->a] + gp_regs[op->b] + op->d);
+    EXIT_BLOCK(0)
+  HANDLER_CASE(H_XCHG) {
+    int temp = gp_regs[op->b];
+    gp_regs[op->b] = gp_regs[op->c];
+    gp_regs[op->c] = temp;
+    NEXT_OP
+  }
+  HANDLER_CASE(H_PUSH)
+    gp_regs[op->a] = gp_regs[op->a] + (int)op->d;
+    WRITE(gp_regs[op->c], gp_regs[op->a]);
+    CHECK_CODE_MODIFIED
+    NEXT_OP
+  HANDLER_CASE(H_POP)
+    gp_regs[op->a] = READ(gp_regs[op->b]);
+    gp_regs[op->b] = gp_regs[op->b] + op->d;
+    NEXT_OP
+  HANDLER_CASE(H_CSR_WR_MEM_UPDATE)
+    cs_regs[op->a] = READ(gp_regs[op->b]);
+    gp_regs[op->b] = gp_regs[op->b] + op->d;
+    NEXT_OP
+  HANDLER_CASE(H_ADD)
+    gp_regs[op->a] = gp_regs[op->b] + gp_regs[op->c];
+    NEXT_OP
+  HANDLER_CASE(H_SUB)
+    gp_regs[op->a] = gp_regs[op->b] - gp_regs[op->c];
+    NEXT_OP
+  HANDLER_CASE(H_MUL)
+    gp_regs[op->a] = gp_regs[op->b] * gp_regs[op->c];
+    NEXT_OP
+  HANDLER_CASE(H_DIV)
+    gp_regs[op->a] = gp_regs[op->b] / gp_regs[op->c];
+    NEXT_OP
+  HANDLER_CASE(H_NOT)
+    gp_regs[op->a] = ~gp_regs[op->b];
+    NEXT_OP
+  HANDLER_CASE(H_AND)
+    gp_regs[op->a] = gp_regs[op->b] & gp_regs[op->c];
+    NEXT_OP
+  HANDLER_CASE(H_OR)
+    gp_regs[op->a] = gp_regs[op->b] | gp_regs[op->c];
+    NEXT_OP
+  HANDLER_CASE(H_XOR)
+    gp_regs[op->a] = gp_regs[op->b] ^ gp_regs[op->c];
+    NEXT_OP
+  HANDLER_CASE(H_SHL)
+    gp_regs[op->a] = gp_regs[op->b] << gp_regs[op->c];
+    NEXT_OP
+  HANDLER_CASE(H_SHR)
+    gp_regs[op->a] = gp_regs[op->b] >> gp_regs[op->c];
+    NEXT_OP
+  HANDLER_CASE(H_CSRRD)
+    gp_regs[op->a] = cs_regs[op->b];
+    NEXT_OP
+  HANDLER_CASE(H_CSRWR)
+    cs_regs[op->a] = gp_regs[op->b];
+    NEXT_OP
+  HANDLER_CASE(H_LD_B_D)
+    gp_regs[op->a] = gp_regs[op->b] + op->d;
+    NEXT_OP
+  HANDLER_CASE(H_LD_MEM_B_C_D)
+    // memory that was never written reads as zero
+    gp_regs[op->a] = READ(gp_regs[op->b] + gp_regs[op->c] + op->d);
+    NEXT_OP
+  HANDLER_CASE(H_ST_MEM)
+    WRITE(gp_regs[op->c], gp_regs[op->a] + gp_regs[op->b] + op->d);
+    CHECK_CODE_MODIFIED
+    NEXT_OP
+  HANDLER_CASE(H_ST_MEM_MEM) {
+    int address = READ(gp_regs[op->a] + gp_regs[op->b] + op->d);
+    WRITE(gp_regs[op->c], address);
+    CHECK_CODE_MODIFIED
+    NEXT_OP
+  }
+  HANDLER_CASE(H_JMP_MEM_A_D)
+    gp_regs[PC] = op->nextPc;
+    gp_regs[PC] = READ(gp_regs[op->a] + op->d);
+    EXIT_BLOCK(0)
+  HANDLER_CASE(H_BEQ_MEM_A_D)
+    gp_regs[PC] = op->nextPc;
+    if (gp_regs[op->b] == gp_regs[op->c]) {
+      gp_regs[PC] = READ(gp_regs[op->a] + op->d);
+      EXIT_BLOCK(0)
     }
-    writeFourBytes(gp_regs[nextInstruction.C], gp_regs[nextInstruction.A]);
-  } else if (nextInstruction.M == OP_CODES::POP) {
-    gp_regs[nextInstruction.A] = readFourBytes(gp_regs[nextInstruction.B]);
-    gp_regs[nextInstruction.B] = gp_regs[nextInstruction.B] + nextInstruction.D;
-  } else if (nextInstruction.M == OP_CODES::CSR_WR_MEM_UPDATE) {
-    cs_regs[nextInstruction.A] = readFourBytes(gp_regs[nextInstruction.B]);
-    gp_regs[nextInstruction.B] = gp_regs[nextInstruction.B] + nextInstruction.D;
-  } else if (nextInstruction.M == OP_CODES::ADD) {
-    if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = gp_regs[nextInstruction.B] + gp_regs[nextInstruction.C];
-  } else if (nextInstruction.M == OP_CODES::SUB) {
-    if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = gp_regs[nextInstruction.B] - gp_regs[nextInstruction.C];
-  } else if (nextInstruction.M == OP_CODES::MUL) {
-    if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = gp_regs[nextInstruction.B] * gp_regs[nextInstruction.C];
-  } else if (nextInstruction.M == OP_CODES::DIV) {
-    if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = gp_regs[nextInstruction.B] / gp_regs[nextInstruction.C];
-  } else if (nextInstruction.M == OP_CODES::NOT) {
-    if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = ~gp_regs[nextInstruction.B];
-  } else if (nextInstruction.M == OP_CODES::AND) {
-    if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = gp_regs[nextInstruction.B] & gp_regs[nextInstruction.C];
-  } else if (nextInstruction.M == OP_CODES::OR) {
-    if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = gp_regs[nextInstruction.B] | gp_regs[nextInstruction.C];
-  } else if (nextInstruction.M == OP_CODES::XOR) {
-    if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = gp_regs[nextInstruction.B] ^ gp_regs[nextInstruction.C];
-  } else if (nextInstruction.M == OP_CODES::SHL) {
-    if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = gp_regs[nextInstruction.B] << gp_regs[nextInstruction.C];
-  } else if (nextInstruction.M == OP_CODES::SHR) {
-    if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = gp_regs[nextInstruction.B] >> gp_regs[nextInstruction.C];
-  } else if (nextInstruction.M == OP_CODES::CSRRD) {
-    if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = cs_regs[nextInstruction.B];
-  } else if (nextInstruction.M == OP_CODES::CSRWR) {
-    cs_regs[nextInstruction.A] = gp_regs[nextInstruction.B];
-  } else if (nextInstruction.M == OP_CODES::LD_B_D) {
-     if (nextInstruction.A != 0) gp_regs[nextInstruction.A] = gp_regs[nextInstruction.B] + nextInstruction.D;
-  } else if (nextInstruction.M == OP_CODES::LD_MEM_B_C_D) {
-    
-    if (nextInstruction.A != 0) {
-      if (memory.find(gp_regs[nextInstruction.B] + gp_regs[nextInstruction.C] + nextInstruction.D) != memory.end()) {
-        int data = readFourBytes(gp_regs[nextInstruction.B] + gp_regs[nextInstruction.C] + nextInstruction.D);
-        gp_regs[nextInstruction.A] = data;
-        
+    EXIT_BLOCK(1)
+  HANDLER_CASE(H_BNE_MEM_A_D)
+    gp_regs[PC] = op->nextPc;
+    if (gp_regs[op->b] != gp_regs[op->c]) {
+      gp_regs[PC] = READ(gp_regs[op->a] + op->d);
+      EXIT_BLOCK(0)
+    }
+    EXIT_BLOCK(1)
+  HANDLER_CASE(H_BGT_MEM_A_D)
+    gp_regs[PC] = op->nextPc;
+    if ((signed int)gp_regs[op->b] > (signed int)gp_regs[op->c]) {
+      gp_regs[PC] = READ(gp_regs[op->a] + op->d);
+      EXIT_BLOCK(0)
+    }
+    EXIT_BLOCK(1)
+  HANDLER_CASE(H_BAD_INSTRUCTION)
+    gp_regs[PC] = op->nextPc;
+    badInstruction = true;
+    EXIT_BLOCK(1)
+  HANDLER_CASE(H_LD_LITERAL)
+    gp_regs[op->a] = READ(op->d + gp_regs[op->c]);
+    NEXT_OP
+  HANDLER_CASE(H_LD_LITERAL_PUSH)
+    gp_regs[op->a] = READ(op->d + gp_regs[op->c]);
+    gp_regs[op->b] = gp_regs[op->b] + op->e;
+    WRITE(gp_regs[op->a], gp_regs[op->b]);
+    CHECK_CODE_MODIFIED
+    NEXT_OP
+  HANDLER_CASE(H_SYNC_PC)
+    gp_regs[PC] = op->nextPc;
+    NEXT_OP
+  HANDLER_CASE(H_EXIT)
+    gp_regs[PC] = op->nextPc;
+    EXIT_BLOCK(1)
+  HANDLER_CASE(H_EXIT_DYNAMIC)
+    EXIT_BLOCK(0)
+  HANDLER_CASE(H_BREAKPOINT)
+    // leaves the execution loop like a halt, the debugger takes it from there
+    gp_regs[PC] = op->nextPc;
+    halted = true;
+    breakpointHit = true;
+    EXIT_BLOCK(1)
+  }
+  return 0;
+}
+
+#undef HANDLER_CASE
+#undef NEXT_OP
+#undef EXIT_BLOCK
+#undef CHECK_CODE_MODIFIED
+#undef READ
+#undef WRITE
+
+// Checks the budget limits, returns true when execution has to stop.
+// Called only when the retired instruction count passes nextCheckpoint or the cycle count passes
+// cycleLimit, so the hot loop pays two compares per block for budgets and devices together.
+bool Emulator::checkBudget() {
+  if (retiredInstructions >= debugStop) {
+    stopReason = "step";
+    return true;
+  }
+  if (debugger && debugger->interruptRequested()) {
+    stopReason = "interrupt";
+    return true;
+  }
+  if (replayStopped) {
+    stopReason = "time";
+    return true;
+  }
+  if (maxInstructions != 0 && retiredInstructions >= maxInstructions) {
+    stopReason = "instruction";
+    return true;
+  }
+  if (maxCycles != 0 && cycles >= maxCycles) {
+    stopReason = "cycle";
+    return true;
+  }
+  if (maxMilliseconds != 0) {
+    auto elapsed = std::chrono::steady_clock::now() - executionStart;
+    if (std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() >= maxMilliseconds) {
+      stopReason = "time";
+      return true;
+    }
+  }
+
+  // the clock and a debugger's ^C are checked at the same interval
+  nextCheckpoint = maxMilliseconds != 0 || debugger ? retiredInstructions + CLOCK_CHECK_INTERVAL : ~0ULL;
+  if (maxInstructions != 0 && maxInstructions < nextCheckpoint) nextCheckpoint = maxInstructions;
+  if (debugStop < nextCheckpoint) nextCheckpoint = debugStop;
+  // stop exactly where the next event has to be injected
+  if (replaying && nextEvent < events.size() && events.at(nextEvent).retired < nextCheckpoint) {
+    nextCheckpoint = events.at(nextEvent).retired;
+  }
+  return false;
+}
+
+void Emulator::executeBlocks() {
+  if (tracing) {
+    if (profiler) executeBlocksLoop<true, true>();
+    else executeBlocksLoop<false, true>();
+  } else {
+    if (profiler) executeBlocksLoop<true, false>();
+    else executeBlocksLoop<false, false>();
+  }
+}
+
+// Instantiated with and without the profiler and trace hooks, so a plain run doesn't pay for them.
+// Compiled blocks can't be traced, tracing runs everything through the interpreter.
+template <bool PROFILE, bool TRACE>
+void Emulator::executeBlocksLoop() {
+  executionStart = std::chrono::steady_clock::now();
+  // events before the current count already happened, the run may start from a snapshot
+  for (nextEvent = 0; replaying && nextEvent < events.size() && events.at(nextEvent).retired < retiredInstructions; nextEvent++) {}
+  updateCycleLimit();
+  if (checkBudget()) return;
+
+  if (PROFILE) profiler->start(gp_regs[PC]);
+  Block* block = findBlock(gp_regs[PC]);
+
+  while (!halted) {
+    if (retiredInstructions + block->instructions > nextCheckpoint || cycles >= cycleLimit) {
+      bool replayed = replaying && replayEvents();
+      if (checkBudget()) break;
+      if (replayed || (cycles >= cycleLimit && deliverInterrupts())) {
+        if (PROFILE) profiler->call(gp_regs[PC]);
+        block = findBlock(gp_regs[PC]);
+        continue;
       }
-      else {
-        gp_regs[nextInstruction.A] = 0;
+      if (retiredInstructions + block->instructions > nextCheckpoint) {
+        // run only the part of the block that still fits before the checkpoint
+        std::unique_ptr<Block> partial(translateBlock(gp_regs[PC], nextCheckpoint - retiredInstructions));
+        unsigned int result = runBlock<TRACE>(partial.get());
+        const MicroOp& exitOp = partial->ops.at(result >> 1);
+        retiredInstructions += exitOp.retired;
+        cycles += exitOp.cycles;
+        if (PROFILE) {
+          profiler->recordBlock(partial.get(), result >> 1, result & 1, gp_regs[PC]);
+          profiler->foldBlock(partial.get());
+        }
+        if (raisePendingException() && PROFILE) profiler->call(gp_regs[PC]);
+        if (codeModified) flushBlocks();
+        if (!halted) block = findBlock(gp_regs[PC]);
+        continue;
       }
     }
-  } else if (nextInstruction.M == OP_CODES::ST_MEM) {
-    writeFourBytes(gp_regs[nextInstruction.C], gp_regs[nextInstruction.A] + gp_regs[nextInstruction.B] + nextInstruction.D);
-  } else if (nextInstruction.M == OP_CODES::ST_MEM_MEM) {
-    
-    int address = readFourBytes(gp_regs[nextInstruction.A] + gp_regs[nextInstruction.B] + nextInstruction.D);
-    writeFourBytes(gp_regs[nextInstruction.C], address);
-  } else if (nextInstruction.M == OP_CODES::JMP_MEM_A_D) {
-    int data = readFourBytes(gp_regs[nextInstruction.A] + nextInstruction.D);
-    gp_regs[PC] = data;
-  } else if (nextInstruction.M == OP_CODES::BEQ_MEM_A_D) {
-    if (gp_regs[nextInstruction.B] == gp_regs[nextInstruction.C]) {
-      int data = readFourBytes(gp_regs[nextInstruction.A] + nextInstruction.D);
-      gp_regs[PC] = data;
+
+    unsigned int result;
+    if (!TRACE && block->native != nullptr) {
+      result = block->native(gp_regs, this, cs_regs);
+    } else {
+      if (!TRACE && jitEnabled && block->executions == jitThreshold) compileBlock(block);
+      result = runBlock<TRACE>(block);
     }
-  } else if (nextInstruction.M == OP_CODES::BNE_MEM_A_D) {
-    if (gp_regs[nextInstruction.B] != gp_regs[nextInstruction.C]) {
-      int data = readFourBytes(gp_regs[nextInstruction.A] + nextInstruction.D);
-      gp_regs[PC] = data;
+    int exitSlot = result & 1;
+    const MicroOp& exitOp = block->ops[result >> 1];
+    block->executions++;
+    block->retired += exitOp.retired;
+    retiredInstructions += exitOp.retired;
+    cycles += exitOp.cycles;
+    if (PROFILE) profiler->recordBlock(block, result >> 1, exitSlot, gp_regs[PC]);
+
+    if (raisePendingException() && PROFILE) profiler->call(gp_regs[PC]);
+    if (halted) break;
+
+    if (codeModified) {
+      flushBlocks();
+      block = findBlock(gp_regs[PC]);
+      continue;
     }
-  } else if (nextInstruction.M == OP_CODES::BGT_MEM_A_D) {
-    if ((signed int)gp_regs[nextInstruction.B] > (signed int)gp_regs[nextInstruction.C]) {
-      int data = readFourBytes(gp_regs[nextInstruction.A] + nextInstruction.D);
-      gp_regs[PC] = data;
+
+    // follow the chained successor while it still starts where execution continues
+    Block* next = block->successors[exitSlot];
+    if (next == nullptr || next->startPc != (unsigned int)gp_regs[PC]) {
+      next = findBlock(gp_regs[PC]);
+      block->successors[exitSlot] = next;
     }
-  } else {
-    badInstruction = true;
+    block = next;
+  }
+
+  if (PROFILE) {
+    for (auto it = blocks.begin(); it != blocks.end(); it++) profiler->foldBlock(it->second.get());
   }
 }
 
-int Emulator::readFourBytes(unsigned int address) {
-  int data = 0;
+// Returns true if an exception was raised and PC moved to the handler.
+bool Emulator::raisePendingException() {
+  if (!badInstruction) return false;
+  badInstruction = false;
+  gp_regs[SP] -= 4;
+  writeFourBytes(cs_regs[STATUS], gp_regs[SP]);
+  gp_regs[SP] -= 4;
+  writeFourBytes(gp_regs[PC], gp_regs[SP]);
+  cs_regs[CAUSE] = CAUSE_BAD_INSTRUCTION;
+  cs_regs[STATUS] = cs_regs[STATUS] & (~0x1);
+  gp_regs[PC] = cs_regs[HANDLER];
+  return true;
+}
 
-  if (memory.find(address) != memory.end()) {
-    data = memory[address] & 0b11111111;
+// Same sequence for the INT instruction and device interrupts.
+void Emulator::raiseInterrupt(int cause) {
+  gp_regs[SP] -= 4;
+  writeFourBytes(gp_regs[PC], gp_regs[SP]);
+  gp_regs[SP] -= 4;
+  writeFourBytes(cs_regs[STATUS], gp_regs[SP]);
+  cs_regs[CAUSE] = cause;
+  cs_regs[STATUS] = cs_regs[STATUS] & (~0x1);
+  gp_regs[PC] = cs_regs[HANDLER];
+}
+
+// Runs between blocks once cycles reach cycleLimit, returns true if PC moved to the handler.
+bool Emulator::deliverInterrupts() {
+  if (timer.isExpired(cycles)) {
+    timer.acknowledge(cycles);
+    timerPending = true;
   }
-  address++;
 
-  if (memory.find(address) != memory.end()) {
-    data = data | ((memory[address] & 0b11111111) << 8);
+  if (cycles >= nextTerminalPoll) {
+    nextTerminalPoll = cycles + TERMINAL_POLL_CYCLES;
+    unsigned char c;
+    if (!terminalPending && terminal.read(c)) {
+      writeFourBytes(c, TERM_IN);
+      terminalPending = true;
+      if (recording) events.add(retiredInstructions, EVENT_TERMINAL_INPUT, c);
+    }
   }
-  address++;
 
-  if (memory.find(address) != memory.end()) {
-    data = data | ((memory[address] & 0b11111111) << 16);
+  // one interrupt at a time, the other one stays pending until the next block
+  bool delivered = false;
+  if (timerPending && (cs_regs[STATUS] & (STATUS_TIMER_MASK | STATUS_INTERRUPT_MASK)) == 0) {
+    timerPending = false;
+    raiseInterrupt(CAUSE_TIMER);
+    delivered = true;
+    if (recording) events.add(retiredInstructions, CAUSE_TIMER, 0);
+  } else if (terminalPending && (cs_regs[STATUS] & (STATUS_TERMINAL_MASK | STATUS_INTERRUPT_MASK)) == 0) {
+    terminalPending = false;
+    raiseInterrupt(CAUSE_TERMINAL);
+    delivered = true;
+    if (recording) events.add(retiredInstructions, CAUSE_TERMINAL, 0);
   }
-  address++;
 
-  if (memory.find(address) != memory.end()) {
-    data = data | ((memory[address] & 0b11111111) << 24);
+  updateCycleLimit();
+  return delivered;
+}
+
+// Injects the events recorded for the current instruction count, returns true if PC moved to the handler.
+// Interrupts are raised even if masked now, they were delivered at this point of the recorded run.
+bool Emulator::replayEvents() {
+  bool delivered = false;
+  while (nextEvent < events.size() && events.at(nextEvent).retired <= retiredInstructions) {
+    const Event& event = events.at(nextEvent++);
+    if (event.cause == EVENT_TERMINAL_INPUT) {
+      writeFourBytes(event.payload, TERM_IN);
+    } else if (event.cause == EVENT_STOP) {
+      replayStopped = true;
+    } else {
+      raiseInterrupt(event.cause);
+      delivered = true;
+    }
   }
+  return delivered;
+}
 
-  return data;
+// While replaying the devices are left out, only the cycle budget needs attention.
+void Emulator::updateCycleLimit() {
+  cycleLimit = maxCycles != 0 ? maxCycles : ~0ULL;
+  if (replaying) return;
+  if (timer.getDeadline() < cycleLimit) cycleLimit = timer.getDeadline();
+  if (nextTerminalPoll < cycleLimit) cycleLimit = nextTerminalPoll;
+  if (timerPending || terminalPending) cycleLimit = cycles; // masked, look again after every block
 }
 
-void Emulator::writeFourBytes(int data, unsigned int address) {
-  char first, second, third, fourth;
+void Emulator::writeDevice(unsigned int address, int data) {
+  if (address == TERM_OUT) {
+    terminal.write(data & 0xff);
+  } else if (address == TIM_CFG) {
+    timer.configure(data, cycles);
+    updateCycleLimit();
+  }
+}
 
-  first = data & 0b11111111;
-  second = (data >> 8) & 0b11111111;
-  third = (data >> 16) & 0b11111111;
-  fourth = (data >> 24) & 0b11111111;
+int Emulator::readFourBytes(unsigned int address) {
+  return memory.readWord(address);
+}
 
-  memory[address++] = first;
-  memory[address++] = second;
-  memory[address++] = third;
-  memory[address] = fourth;
+void Emulator::writeFourBytes(int data, unsigned int address) {
+  if (memory.writeWord(address, data)) {
+    invalidateInstructions(address);
+    codeModified = true;
+  }
+  if (address >= MMIO_BASE) writeDevice(address, data);
 }
 
 void Emulator::setInputFile(std::string str) {
   inputFileStr = str;
 }
 
+void Emulator::setRestoreFile(std::string str) {
+  restoreFileStr = str;
+}
+
+void Emulator::setSaveFile(std::string str) {
+  saveFileStr = str;
+}
+
+void Emulator::setProfile(bool boolean) {
+  if (boolean) profiler.reset(new Profiler());
+  else profiler.reset();
+}
+
+void Emulator::setSymbolFile(std::string str) {
+  symbolFileStr = str;
+}
+
+void Emulator::setMapFile(std::string str) {
+  mapFileStr = str;
+}
+
+void Emulator::setGdb(std::string str) {
+  gdbAddressStr = str;
+}
+
+void Emulator::setRecordFile(std::string str) {
+  recordFileStr = str;
+}
+
+void Emulator::setReplayFile(std::string str) {
+  replayFileStr = str;
+}
+
+void Emulator::setTraceFile(std::string str) {
+  traceFileStr = str;
+  if (str != "") tracer.reset(new Tracer());
+  else tracer.reset();
+}
+
+void Emulator::setConsole(bool boolean) {
+  console = boolean;
+}
+
+void Emulator::setStats(bool boolean) {
+  stats = boolean;
+}
+
+void Emulator::setBlockStats(bool boolean) {
+  blockStats = boolean;
+}
+
+void Emulator::setMaxInstructions(unsigned long long num) {
+  maxInstructions = num;
+}
+
+void Emulator::setMaxCycles(unsigned long long num) {
+  maxCycles = num;
+}
+
+void Emulator::setMaxTime(unsigned long long milliseconds) {
+  maxMilliseconds = milliseconds;
+}
+
+void Emulator::setJit(bool boolean) {
+  jitEnabled = boolean;
+}
+
+void Emulator::setJitVerify(bool boolean) {
+  jitVerify = boolean;
+}
+
+void Emulator::setJitThreshold(unsigned int count) {
+  jitThreshold = count;
+}
+
+void Emulator::printStats() {
+  std::cout << "-----------------------------------------------------------------\n";
+  std::cout << "Startup time: " << std::dec << startupMicroseconds << " us\n";
+  std::cout << "Execution time: " << executionMicroseconds << " us\n";
+  std::cout << "Instructions retired: " << retiredInstructions << "\n";
+  std::cout << "Guest cycles: " << cycles << "\n";
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) std::cout << "Peak RSS: " << usage.ru_maxrss << " KiB\n";
+  if (executionMicroseconds != 0) {
+    std::cout << "MIPS: " << std::fixed << std::setprecision(2) << (double)retiredInstructions / executionMicroseconds << "\n";
+  }
+  if (retiredInstructions != 0) {
+    std::cout << "ns/instruction: " << std::fixed << std::setprecision(2) << executionMicroseconds * 1000.0 / retiredInstructions << "\n";
+  }
+}
+
+void Emulator::printBlockStats() {
+  std::vector<Block*> sorted;
+  for (auto it = blocks.begin(); it != blocks.end(); it++) sorted.push_back(it->second.get());
+  std::sort(sorted.begin(), sorted.end(), [](Block* x, Block* y) { return x->retired > y->retired; });
+
+  std::cout << "Blocks translated: " << std::dec << blocksTranslated << "\n";
+  std::cout << "Blocks compiled: " << blocksCompiled << "\n";
+  for (int i = 0; i < sorted.size() && i < 10; i++) {
+    std::cout << "  block 0x" << std::setw(8) << std::setfill('0') << std::hex << sorted.at(i)->startPc << std::dec
+              << ": " << sorted.at(i)->instructions << " instructions, executed " << sorted.at(i)->executions
+              << " times, " << sorted.at(i)->retired << " retired\n";
+  }
+}
+
 void Emulator::memoryDump() {
   std::ofstream outputFile("mem_content.hex", std::ios::out);
   bool firstLine = true;
   int prevAddr = 0;
   int counter = 0;
 
-  for (auto it = memory.begin(); it != memory.end(); it++) {
-    int currAddr = it->first;
-    unsigned char value = it->second;
-
+  memory.forEachWrittenByte([&](unsigned int currAddr, unsigned char value) {
     if (counter % 8 == 0 || currAddr != prevAddr + 1) {
       if (!firstLine) outputFile << '\n';
       firstLine = false;
@@ -254,32 +1150,207 @@ void Emulator::memoryDump() {
 
     counter++;
     prevAddr = currAddr;
+  });
+}
+
+// Runs the image once interpreted and once with the JIT, then compares the final machine state.
+bool Emulator::verifyJit() {
+  std::unique_ptr<Snapshot> start = takeSnapshot();
+  if (start == nullptr) {
+    std::cout << "could not snapshot the machine before running\n";
+    return false;
   }
+
+  jitEnabled = false;
+  executeBlocks();
+
+  std::vector<int> expectedRegs(gp_regs, gp_regs + GP_REGS_NUM);
+  expectedRegs.insert(expectedRegs.end(), cs_regs, cs_regs + CS_REGS_NUM);
+  std::vector<std::pair<unsigned int, unsigned char>> expectedMemory;
+  memory.forEachWrittenByte([&](unsigned int address, unsigned char value) {
+    expectedMemory.push_back(std::make_pair(address, value));
+  });
+  unsigned long long expectedRetired = retiredInstructions;
+
+  restoreSnapshot(*start);
+  jitEnabled = true;
+  executeBlocks();
+
+  bool passed = true;
+  for (int i = 0; i < GP_REGS_NUM + CS_REGS_NUM; i++) {
+    int actual = i < GP_REGS_NUM ? gp_regs[i] : cs_regs[i - GP_REGS_NUM];
+    if (actual != expectedRegs.at(i)) {
+      std::cout << (i < GP_REGS_NUM ? "r" : "csr") << std::dec << (i < GP_REGS_NUM ? i : i - GP_REGS_NUM)
+                << " differs: interpreter 0x" << std::hex << expectedRegs.at(i) << ", jit 0x" << actual << "\n";
+      passed = false;
+    }
+  }
+
+  int index = 0;
+  bool memoryMatches = true;
+  memory.forEachWrittenByte([&](unsigned int address, unsigned char value) {
+    if (index >= expectedMemory.size() || expectedMemory.at(index) != std::make_pair(address, value)) memoryMatches = false;
+    index++;
+  });
+  if (!memoryMatches || index != expectedMemory.size()) {
+    std::cout << "memory contents differ between interpreter and jit\n";
+    passed = false;
+  }
+
+  if (retiredInstructions != expectedRetired) {
+    std::cout << "retired instructions differ: interpreter " << std::dec << expectedRetired << ", jit " << retiredInstructions << "\n";
+    passed = false;
+  }
+
+  return passed;
 }
 
-void Emulator::execute() {
-  if (readInputFile() == false) {
-    std::cout << "input file '" << inputFileStr << "' does not exist.\n";
-    return;
+int Emulator::run() {
+  reset();
+
+  if (replayFileStr != "") {
+    if (!events.read(replayFileStr)) return EMULATOR_LOAD_FAILED;
+    replaying = true;
   }
 
-  int counter = 0;
-  
-  while (halted != true && counter != 20) {
-    fetchInstruction();
-    executeInstruction();
-    if (badInstruction) {
-      gp_regs[SP] -= 4;
-      writeFourBytes(cs_regs[STATUS], gp_regs[SP]);
-      gp_regs[SP] -= 4;
-      writeFourBytes(gp_regs[PC], gp_regs[SP]);
-      cs_regs[CAUSE] = 0x1;
-      cs_regs[STATUS] = cs_regs[STATUS] & (~0x1);
-      gp_regs[PC] = cs_regs[HANDLER];
+  auto startupStart = std::chrono::steady_clock::now();
+  bool loaded = restoreFileStr != "" ? restoreSnapshot(restoreFileStr) : readInputFile();
+  if (loaded == false) return EMULATOR_LOAD_FAILED;
+
+  auto executionBegin = std::chrono::steady_clock::now();
+  startupMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(executionBegin - startupStart).count();
+
+  // not while verifying, the two runs would be recorded one after the other
+  recording = recordFileStr != "" && !jitVerify && !replaying;
+  if (gdbAddressStr != "" && !jitVerify) {
+    debugger.reset(new GdbStub(*this));
+    if (!debugger->listen(gdbAddressStr)) {
+      debugger.reset();
+      stopReason = "debugger";
+      return EMULATOR_LOAD_FAILED;
+    }
+  }
+
+  if (console) terminal.start();
+  if (jitVerify) {
+    jitPassed = verifyJit();
+  } else {
+    tracing = tracer && tracer->start(traceFileStr);
+    if (debugger) {
+      // after a detach the guest goes on without the debugger
+      bool detached = debugger->serve();
+      debugger.reset();
+      if (detached) executeBlocks();
+      else stopReason = "kill";
+    } else {
+      executeBlocks();
+    }
+    if (tracing) tracer->stop();
+  }
+  if (recording && stopReason == "time") events.add(retiredInstructions, EVENT_STOP, 0);
+  terminal.stop();
+
+  auto elapsed = std::chrono::steady_clock::now() - executionBegin;
+  executionMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+
+  return halted ? EMULATOR_HALTED : EMULATOR_BUDGET_EXHAUSTED;
+}
+
+// next to the image, "program.lnk" -> "program" + extension
+static std::string besideImage(std::string image, const std::string& extension) {
+  if (image.size() >= 4 && image.compare(image.size() - 4, 4, ".lnk") == 0) image.erase(image.size() - 4);
+  return image + extension;
+}
+
+int Emulator::execute() {
+  if (profiler) {
+    std::string symbolFile = symbolFileStr != "" ? symbolFileStr : besideImage(inputFileStr, ".sym");
+    if (!profiler->loadSymbols(symbolFile)) {
+      std::cout << "symbol file '" << symbolFile << "' does not exist, profile will show addresses only.\n";
+    }
+  }
+
+  // only a map that was asked for has to be there
+  if (mapFileStr != "") {
+    hasMap = symbolMap.load(mapFileStr);
+    if (!hasMap) std::cout << "map file '" << mapFileStr << "' does not exist, addresses will not be symbolized.\n";
+  } else if (inputFileStr != "") {
+    hasMap = symbolMap.load(besideImage(inputFileStr, ".map"));
+  }
+
+  int status = run();
+  if (status == EMULATOR_LOAD_FAILED && stopReason == "debugger") {
+    std::cout << "could not listen for gdb on '" << gdbAddressStr << "'.\n";
+    return status;
+  }
+  if (status == EMULATOR_LOAD_FAILED && replayFileStr != "" && !replaying) {
+    std::cout << "event log '" << replayFileStr << "' could not be read.\n";
+    return status;
+  }
+  if (status == EMULATOR_LOAD_FAILED && restoreFileStr != "") {
+    std::cout << "snapshot '" << restoreFileStr << "' could not be restored.\n";
+    return status;
+  }
+  if (status == EMULATOR_LOAD_FAILED) {
+    std::cout << "input file '" << inputFileStr << "' does not exist or is not a linked image.\n";
+    return status;
+  }
+  if (restoreFileStr != "") {
+    std::cout << "restored snapshot '" << restoreFileStr << "': " << std::dec << snapshotSize << " bytes in "
+              << startupMicroseconds << " us\n";
+  }
+
+  if (tracer && !tracing && !jitVerify) {
+    std::cout << "trace file '" << traceFileStr << "' could not be created.\n";
+  } else if (tracing) {
+    std::cout << "trace '" << traceFileStr << "': " << std::dec << tracer->getRecords() << " records, "
+              << tracer->getBytes() << " bytes\n";
+  }
+  if (jitVerify) std::cout << (jitPassed ? "JIT verification passed\n" : "JIT verification failed\n");
+  if (status == EMULATOR_BUDGET_EXHAUSTED && stopReason == "kill") {
+    std::cout << "emulation killed by gdb at pc=" << describeAddress(gp_regs[PC]) << "\n";
+  } else if (status == EMULATOR_BUDGET_EXHAUSTED) {
+    std::cout << "emulation stopped: " << stopReason << " budget exhausted at pc=" << describeAddress(gp_regs[PC]) << "\n";
+  }
+
+  if (recording) {
+    if (events.write(recordFileStr)) {
+      std::cout << "recorded " << std::dec << events.size() << " events in '" << recordFileStr << "'\n";
+    } else {
+      std::cout << "could not write event log '" << recordFileStr << "'.\n";
+    }
+  } else if (replaying) {
+    std::cout << "replayed " << std::dec << nextEvent << " of " << events.size() << " events from '" << replayFileStr << "'\n";
+  }
+
+  if (saveFileStr != "") {
+    auto saveStart = std::chrono::steady_clock::now();
+    if (saveSnapshot(saveFileStr)) {
+      auto elapsed = std::chrono::steady_clock::now() - saveStart;
+      std::cout << "saved snapshot '" << saveFileStr << "': " << std::dec << snapshotSize << " bytes in "
+                << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() << " us\n";
+    } else {
+      std::cout << "could not save snapshot '" << saveFileStr << "'.\n";
     }
-    if (halted) break;
   }
 
   printRegisters();
+  if (stats || blockStats) printStats();
+  if (blockStats) printBlockStats();
+  if (profiler && !profiler->write("profile.txt", "profile.folded")) {
+    std::cout << "could not write profile.txt and profile.folded.\n";
+  }
   memoryDump();
-}
\ No newline at end of file
+  return status;
+}
+
+unsigned long long Emulator::memoryHash() {
+  unsigned long long hash = 0xcbf29ce484222325ULL;
+  memory.forEachWrittenByte([&](unsigned int address, unsigned char value) {
+    for (int i = 0; i < 4; i++) {
+      hash = (hash ^ ((address >> (8 * i)) & 0xff)) * 0x100000001b3ULL;
+    }
+    hash = (hash ^ value) * 0x100000001b3ULL;
+  });
+  return hash;
+}
@@ -0,0 +1,34 @@
+#include "../inc/event_log.hpp"
+#include <fstream>
+#include <cstring>
+
+void EventLog::add(unsigned long long retired, int cause, int payload) {
+  Event event = {retired, cause, payload};
+  events.push_back(event);
+}
+
+bool EventLog::read(std::string file) {
+  std::ifstream input(file, std::ios::binary);
+  if (!input) return false;
+
+  char magic[sizeof(EVENT_LOG_MAGIC) - 1];
+  unsigned long long count;
+  input.read(magic, sizeof(magic));
+  input.read((char*)&count, sizeof(count));
+  if (!input || memcmp(magic, EVENT_LOG_MAGIC, sizeof(magic)) != 0) return false;
+
+  events.resize(count);
+  input.read((char*)events.data(), count * sizeof(Event));
+  return (bool)input;
+}
+
+bool EventLog::write(std::string file) const {
+  std::ofstream output(file, std::ios::binary);
+  if (!output) return false;
+
+  unsigned long long count = events.size();
+  output.write(EVENT_LOG_MAGIC, sizeof(EVENT_LOG_MAGIC) - 1);
+  output.write((const char*)&count, sizeof(count));
+  output.write((const char*)events.data(), count * sizeof(Event));
+  return (bool)output;
+}
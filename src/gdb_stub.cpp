@@ -0,0 +1,323 @@
+#include "../inc/gdb_stub.hpp"
+#include "../inc/emulator.hpp"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#define GDB_REGS_NUM (GP_REGS_NUM + CS_REGS_NUM)
+
+static const char hexDigits[] = "0123456789abcdef";
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Reads hex digits starting at position, leaves position at the first other character.
+static unsigned int parseHex(const std::string& str, size_t& position) {
+  unsigned int value = 0;
+  while (position < str.size() && hexValue(str[position]) >= 0) {
+    value = (value << 4) | hexValue(str[position++]);
+  }
+  return value;
+}
+
+static void appendByte(std::string& out, unsigned char b) {
+  out += hexDigits[b >> 4];
+  out += hexDigits[b & 15];
+}
+
+// Registers travel in target byte order, which is little endian.
+static void appendRegister(std::string& out, int value) {
+  for (int i = 0; i < 4; i++) appendByte(out, ((unsigned int)value >> (8 * i)) & 0xff);
+}
+
+static bool parseRegister(const std::string& str, size_t position, int& value) {
+  if (position + 8 > str.size()) return false;
+  unsigned int result = 0;
+  for (int i = 0; i < 4; i++) {
+    int high = hexValue(str[position + 2 * i]);
+    int low = hexValue(str[position + 2 * i + 1]);
+    if (high < 0 || low < 0) return false;
+    result |= (unsigned int)((high << 4) | low) << (8 * i);
+  }
+  value = result;
+  return true;
+}
+
+GdbStub::GdbStub(Emulator& emulator) : emulator(emulator) {
+  listenFd = -1;
+  fd = -1;
+  noAck = false;
+  exited = false;
+}
+
+GdbStub::~GdbStub() {
+  if (fd >= 0) close(fd);
+  if (listenFd >= 0) close(listenFd);
+  if (socketPath != "") unlink(socketPath.c_str());
+}
+
+bool GdbStub::listen(std::string address) {
+  size_t colon = address.rfind(':');
+  bool tcp = colon != std::string::npos;
+
+  if (tcp) {
+    std::string host = colon == 0 ? "127.0.0.1" : address.substr(0, colon);
+    sockaddr_in socketAddress = {};
+    socketAddress.sin_family = AF_INET;
+    socketAddress.sin_port = htons(std::stoi(address.substr(colon + 1)));
+    if (inet_pton(AF_INET, host.c_str(), &socketAddress.sin_addr) != 1) return false;
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (listenFd < 0 || bind(listenFd, (sockaddr*)&socketAddress, sizeof(socketAddress)) < 0) return false;
+  } else {
+    sockaddr_un socketAddress = {};
+    socketAddress.sun_family = AF_UNIX;
+    if (address.size() >= sizeof(socketAddress.sun_path)) return false;
+    memcpy(socketAddress.sun_path, address.c_str(), address.size());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(address.c_str());
+    if (listenFd < 0 || bind(listenFd, (sockaddr*)&socketAddress, sizeof(socketAddress)) < 0) return false;
+    socketPath = address;
+  }
+
+  if (::listen(listenFd, 1) < 0) return false;
+  std::cout << "waiting for gdb on '" << address << "'\n";
+  std::cout.flush();
+
+  fd = accept(listenFd, nullptr, nullptr);
+  if (fd < 0) return false;
+  if (tcp) {
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+  }
+  return true;
+}
+
+bool GdbStub::serve() {
+  std::string packet;
+  while (readPacket(packet)) {
+    std::string reply;
+    char command = packet.empty() ? 0 : packet[0];
+    size_t position = 1;
+
+    if (packet.rfind("qSupported", 0) == 0) {
+      reply = "PacketSize=4000;QStartNoAckMode+";
+    } else if (packet == "QStartNoAckMode") {
+      sendPacket("OK");
+      noAck = true;
+      continue;
+    } else if (packet == "qAttached") {
+      reply = "1";
+    } else if (packet == "qC") {
+      reply = "QC1";
+    } else if (packet == "qfThreadInfo") {
+      reply = "m1";
+    } else if (packet == "qsThreadInfo") {
+      reply = "l";
+    } else if (command == '?') {
+      reply = "S05";
+    } else if (command == 'g') {
+      reply = readRegisters();
+    } else if (command == 'G') {
+      int values[GDB_REGS_NUM];
+      bool valid = true;
+      for (int i = 0; i < GDB_REGS_NUM && valid; i++) valid = parseRegister(packet, 1 + 8 * i, values[i]);
+      if (valid) {
+        for (int i = 0; i < GP_REGS_NUM; i++) emulator.gp_regs[i] = values[i];
+        for (int i = 0; i < CS_REGS_NUM; i++) emulator.cs_regs[i] = values[GP_REGS_NUM + i];
+      }
+      reply = valid ? "OK" : "E01";
+    } else if (command == 'p') {
+      unsigned int index = parseHex(packet, position);
+      if (index < GDB_REGS_NUM) {
+        appendRegister(reply, index < GP_REGS_NUM ? emulator.gp_regs[index] : emulator.cs_regs[index - GP_REGS_NUM]);
+      } else {
+        reply = "E01";
+      }
+    } else if (command == 'P') {
+      unsigned int index = parseHex(packet, position);
+      int value;
+      if (index < GDB_REGS_NUM && position < packet.size() && packet[position] == '=' && parseRegister(packet, position + 1, value)) {
+        if (index < GP_REGS_NUM) emulator.gp_regs[index] = value;
+        else emulator.cs_regs[index - GP_REGS_NUM] = value;
+        reply = "OK";
+      } else {
+        reply = "E01";
+      }
+    } else if (command == 'm' || command == 'M') {
+      unsigned int address = parseHex(packet, position);
+      position++; // ','
+      unsigned int length = parseHex(packet, position);
+      if (command == 'm') {
+        reply = readMemory(address, length);
+      } else {
+        bool valid = position < packet.size() && packet[position] == ':';
+        reply = valid && writeMemory(address, length, packet.substr(position + 1)) ? "OK" : "E01";
+      }
+    } else if (command == 'Z' || command == 'z') {
+      // software and hardware breakpoints are the same thing here, watchpoints are not supported
+      unsigned int type = parseHex(packet, position);
+      position++;
+      unsigned int address = parseHex(packet, position);
+      if (type == 0 || type == 1) {
+        emulator.setBreakpoint(address, command == 'Z');
+        reply = "OK";
+      }
+    } else if (command == 'c' || command == 's') {
+      if (position < packet.size()) emulator.gp_regs[PC] = parseHex(packet, position);
+      reply = resume(command == 's');
+      if (exited) {
+        sendPacket(reply);
+        return true;
+      }
+    } else if (command == 'H' || command == 'T') {
+      reply = "OK"; // one thread
+    } else if (command == 'D') {
+      sendPacket("OK");
+      return true;
+    } else if (command == 'k') {
+      return false;
+    }
+
+    sendPacket(reply);
+  }
+  return true;
+}
+
+bool GdbStub::interruptRequested() {
+  char buffer[256];
+  ssize_t count = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+  if (count == 0) return true; // debugger went away, stop so that serve finds out
+  if (count < 0) return false;
+
+  pending.append(buffer, count);
+  size_t position = pending.find('\x03');
+  if (position == std::string::npos) return false;
+  pending.erase(position, 1);
+  return true;
+}
+
+bool GdbStub::readByte(char& c) {
+  if (!pending.empty()) {
+    c = pending[0];
+    pending.erase(0, 1);
+    return true;
+  }
+  return recv(fd, &c, 1, 0) == 1;
+}
+
+// "$data#checksum", acknowledged with '+' or '-' unless acks were turned off.
+// Anything outside a packet (acks, a late ^C) is skipped.
+bool GdbStub::readPacket(std::string& packet) {
+  while (true) {
+    char c;
+    do {
+      if (!readByte(c)) return false;
+    } while (c != '$');
+
+    packet.clear();
+    unsigned char sum = 0;
+    while (true) {
+      if (!readByte(c)) return false;
+      if (c == '#') break;
+      packet += c;
+      sum += c;
+    }
+
+    char high, low;
+    if (!readByte(high) || !readByte(low)) return false;
+    if (noAck) return true;
+
+    bool valid = hexValue(high) >= 0 && hexValue(low) >= 0 && ((hexValue(high) << 4) | hexValue(low)) == sum;
+    send(fd, valid ? "+" : "-", 1, MSG_NOSIGNAL);
+    if (valid) return true;
+  }
+}
+
+void GdbStub::sendPacket(const std::string& data) {
+  unsigned char sum = 0;
+  for (int i = 0; i < data.size(); i++) sum += data[i];
+
+  std::string packet = "$" + data + "#";
+  appendByte(packet, sum);
+  const char* position = packet.c_str();
+  size_t size = packet.size();
+  while (size > 0) {
+    ssize_t count = send(fd, position, size, MSG_NOSIGNAL);
+    if (count <= 0) return;
+    position += count;
+    size -= count;
+  }
+}
+
+std::string GdbStub::readRegisters() {
+  std::string reply;
+  for (int i = 0; i < GP_REGS_NUM; i++) appendRegister(reply, emulator.gp_regs[i]);
+  for (int i = 0; i < CS_REGS_NUM; i++) appendRegister(reply, emulator.cs_regs[i]);
+  return reply;
+}
+
+// Memory as the program sees it, breakpoints only live in the decoded instructions.
+std::string GdbStub::readMemory(unsigned int address, unsigned int length) {
+  std::string reply;
+  for (unsigned int i = 0; i < length; i++) appendByte(reply, emulator.memory.readByte(address + i));
+  return reply;
+}
+
+bool GdbStub::writeMemory(unsigned int address, unsigned int length, const std::string& data) {
+  if (data.size() < 2 * (size_t)length) return false;
+  for (unsigned int i = 0; i < length; i++) {
+    int high = hexValue(data[2 * i]);
+    int low = hexValue(data[2 * i + 1]);
+    if (high < 0 || low < 0) return false;
+    emulator.writeDebugByte(address + i, (high << 4) | low);
+  }
+  return true;
+}
+
+std::string GdbStub::resume(bool step) {
+  unsigned int pc = emulator.gp_regs[PC];
+  if (emulator.breakpoints.count(pc) != 0) {
+    // resuming from a breakpoint that is still inserted, execute its instruction first
+    emulator.setBreakpoint(pc, false);
+    runFor(1);
+    emulator.setBreakpoint(pc, true);
+    if (step || emulator.stopReason != "step") return stopReply();
+  }
+  runFor(step ? 1 : 0);
+  return stopReply();
+}
+
+// Runs until a breakpoint, halt, budget or ^C, or for the given number of instructions unless 0.
+void GdbStub::runFor(unsigned long long instructions) {
+  emulator.stopReason = "";
+  emulator.debugStop = instructions != 0 ? emulator.retiredInstructions + instructions : ~0ULL;
+  emulator.executeBlocks();
+  emulator.debugStop = ~0ULL;
+}
+
+std::string GdbStub::stopReply() {
+  if (emulator.breakpointHit) {
+    emulator.breakpointHit = false;
+    emulator.halted = false;
+    return "S05";
+  }
+  if (emulator.halted) {
+    exited = true;
+    return "W00";
+  }
+  if (emulator.stopReason == "step") return "S05";
+  if (emulator.stopReason == "interrupt") return "S02";
+  exited = true; // out of budget, the run is over
+  return "W02";
+}
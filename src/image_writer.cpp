@@ -0,0 +1,157 @@
+#include "../inc/image_writer.hpp"
+#include "../inc/thread_pool.hpp"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+// A run of whole lines within one section.
+struct ImageChunk {
+  int section;
+  unsigned int address;
+  const unsigned char* data;
+  size_t length;
+  bool startsSection;
+  bool startsFile; // its first line is the first of the text, so there is no newline before it
+  size_t textSize;
+};
+
+// "000102...ff", two characters per byte value
+static const char* hexDigits() {
+  static char table[512];
+  static bool filled = [] {
+    const char* digits = "0123456789abcdef";
+    for (int i = 0; i < 256; i++) {
+      table[2 * i] = digits[i >> 4];
+      table[2 * i + 1] = digits[i & 0xf];
+    }
+    return true;
+  }();
+  (void)filled;
+  return table;
+}
+
+// Every line is "aaaaaaaa: " followed by "xx " per byte, lines are separated by a newline.
+static size_t textSize(size_t length, bool startsFile) {
+  size_t lines = (length + 7) / 8;
+  if (lines == 0) return 0;
+  return lines * 10 + length * 3 + lines - (startsFile ? 1 : 0);
+}
+
+static void formatChunk(const ImageChunk& chunk, char* out) {
+  const char* hex = hexDigits();
+  for (size_t k = 0; k < chunk.length; k += 8) {
+    if (k > 0 || !chunk.startsFile) *out++ = '\n';
+    unsigned int address = chunk.address + k;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      memcpy(out, hex + 2 * ((address >> shift) & 0xff), 2);
+      out += 2;
+    }
+    *out++ = ':';
+    *out++ = ' ';
+
+    size_t end = chunk.length - k < 8 ? chunk.length : k + 8;
+    for (size_t j = k; j < end; j++) {
+      memcpy(out, hex + 2 * chunk.data[j], 2);
+      out[2] = ' ';
+      out += 3;
+    }
+  }
+}
+
+// Goes on after partial writes, at most IOV_MAX buffers at a time.
+static bool writeAll(int fd, std::vector<iovec>& buffers) {
+  size_t next = 0;
+  while (next < buffers.size()) {
+    int count = buffers.size() - next < IOV_MAX ? buffers.size() - next : IOV_MAX;
+    ssize_t written = writev(fd, buffers.data() + next, count);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    while (next < buffers.size() && (size_t)written >= buffers.at(next).iov_len) {
+      written -= buffers.at(next).iov_len;
+      next++;
+    }
+    if (written > 0) {
+      buffers.at(next).iov_base = (char*)buffers.at(next).iov_base + written;
+      buffers.at(next).iov_len -= written;
+    }
+  }
+  return true;
+}
+
+bool writeImageFiles(const std::vector<ImageSection>& sections, const std::string& binaryFile, const std::string& textFile, unsigned int threads) {
+  // sections without contents still get a chunk, for their header in the .lnk file
+  std::vector<ImageChunk> chunks;
+  bool startsFile = true;
+  for (int s = 0; s < sections.size(); s++) {
+    const ImageSection& section = sections.at(s);
+    size_t k = 0;
+    do {
+      ImageChunk chunk;
+      chunk.section = s;
+      chunk.address = section.address + k;
+      chunk.data = section.data + k;
+      chunk.length = section.length - k < IMAGE_CHUNK_SIZE ? section.length - k : IMAGE_CHUNK_SIZE;
+      chunk.startsSection = k == 0;
+      chunk.startsFile = startsFile && chunk.length > 0;
+      chunk.textSize = textSize(chunk.length, chunk.startsFile);
+      if (chunk.length > 0) startsFile = false;
+      chunks.push_back(chunk);
+      k += chunk.length;
+    } while (k < section.length);
+  }
+
+  // number of sections, then address and length before each section's contents
+  std::vector<int> headers(1 + 2 * sections.size());
+  headers.at(0) = sections.size();
+  for (int s = 0; s < sections.size(); s++) {
+    headers.at(1 + 2 * s) = sections.at(s).address;
+    headers.at(2 + 2 * s) = sections.at(s).length;
+  }
+
+  int binaryFd = binaryFile == "" ? -1 : open(binaryFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  int textFd = textFile == "" ? -1 : open(textFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  bool written = (binaryFile == "" || binaryFd >= 0) && (textFile == "" || textFd >= 0);
+
+  std::vector<iovec> binaryBuffers;
+  std::vector<iovec> textBuffers;
+  if (written && binaryFd >= 0) {
+    binaryBuffers.push_back({headers.data(), sizeof(int)});
+  }
+
+  // one pool for all windows, a run starts no more threads than the window has chunks
+  ThreadPool pool(threads);
+  std::vector<std::vector<char>> texts(IMAGE_WINDOW_CHUNKS);
+  for (size_t first = 0; written && first < chunks.size(); first += IMAGE_WINDOW_CHUNKS) {
+    size_t last = chunks.size() - first < IMAGE_WINDOW_CHUNKS ? chunks.size() : first + IMAGE_WINDOW_CHUNKS;
+
+    if (textFd >= 0) {
+      for (size_t c = first; c < last; c++) {
+        texts.at(c - first).resize(chunks.at(c).textSize);
+        pool.submit([&chunks, &texts, c, first]() { formatChunk(chunks.at(c), texts.at(c - first).data()); });
+      }
+      pool.run();
+    }
+
+    for (size_t c = first; c < last; c++) {
+      const ImageChunk& chunk = chunks.at(c);
+      if (chunk.textSize > 0) textBuffers.push_back({texts.at(c - first).data(), chunk.textSize});
+      if (chunk.startsSection) binaryBuffers.push_back({headers.data() + 1 + 2 * chunk.section, 2 * sizeof(int)});
+      if (chunk.length > 0) binaryBuffers.push_back({(void*)chunk.data, chunk.length});
+    }
+
+    if (textFd >= 0) written &= writeAll(textFd, textBuffers);
+    if (binaryFd >= 0) written &= writeAll(binaryFd, binaryBuffers);
+    textBuffers.clear();
+    binaryBuffers.clear();
+  }
+  if (written && binaryFd >= 0) written &= writeAll(binaryFd, binaryBuffers); // no sections, only the count
+
+  if (binaryFd >= 0) written &= close(binaryFd) == 0;
+  if (textFd >= 0) written &= close(textFd) == 0;
+  return written;
+}
@@ -0,0 +1,318 @@
+#include "../inc/jit.hpp"
+#include "../inc/emulator.hpp"
+#include <sys/mman.h>
+
+// x86-64 register numbers used in ModRM
+#define EAX 0
+#define ECX 1
+#define EDX 2
+#define ESI 6
+
+// condition codes for jcc
+#define CC_E 0x4
+#define CC_NE 0x5
+#define CC_LE 0xe
+
+Jit::Jit() {
+  void* mapping = mmap(nullptr, JIT_BUFFER_SIZE, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  buffer = mapping == MAP_FAILED ? nullptr : (unsigned char*)mapping;
+  used = 0;
+}
+
+Jit::~Jit() {
+  if (buffer != nullptr) munmap(buffer, JIT_BUFFER_SIZE);
+}
+
+void Jit::reset() {
+  used = 0;
+}
+
+// INT and CSR writes change interrupt state and stay in the interpreter, as do blocks that halt,
+// raise an exception or stop at a breakpoint.
+bool Jit::canCompile(const Block* block) {
+  for (int i = 0; i < block->ops.size(); i++) {
+    HANDLER_ID handler = block->ops.at(i).handler;
+    if (handler == H_INT || handler == H_CSRWR || handler == H_CSR_WR_MEM_UPDATE
+        || handler == H_HALT || handler == H_BAD_INSTRUCTION || handler == H_BREAKPOINT) return false;
+  }
+  return true;
+}
+
+NativeBlock Jit::compile(const Block* block) {
+  if (buffer == nullptr) return nullptr;
+
+  code.clear();
+  // prologue: push rbx; push r12; push r13; mov rbx, rdi; mov r12, rsi; mov r13, rdx
+  const unsigned char prologue[] = {0x53, 0x41, 0x54, 0x41, 0x55, 0x48, 0x89, 0xfb, 0x49, 0x89, 0xf4, 0x49, 0x89, 0xd5};
+  code.insert(code.end(), prologue, prologue + sizeof(prologue));
+
+  for (int i = 0; i < block->ops.size(); i++) {
+    compileOp(block->ops.at(i), i);
+  }
+
+  if (used + code.size() > JIT_BUFFER_SIZE) return nullptr;
+
+  unsigned char* start = buffer + used;
+  mprotect(buffer, JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE);
+  memcpy(start, code.data(), code.size());
+  mprotect(buffer, JIT_BUFFER_SIZE, PROT_READ | PROT_EXEC);
+  used += (code.size() + 15) & ~(size_t)15;
+
+  return (NativeBlock)start;
+}
+
+void Jit::compileOp(const MicroOp& op, unsigned int index) {
+  switch (op.handler) {
+    case H_ADD: case H_SUB: case H_AND: case H_OR: case H_XOR: {
+      unsigned char opcode = op.handler == H_ADD ? 0x03 : op.handler == H_SUB ? 0x2b
+                           : op.handler == H_AND ? 0x23 : op.handler == H_OR ? 0x0b : 0x33;
+      emitLoad(EAX, false, op.b);
+      emitAluMem(opcode, EAX, op.c);
+      emitStore(false, op.a, EAX);
+      break;
+    }
+    case H_MUL:
+      emitLoad(EAX, false, op.b);
+      emitByte(0x0f); // imul eax, [c]
+      emitAluMem(0xaf, EAX, op.c);
+      emitStore(false, op.a, EAX);
+      break;
+    case H_DIV:
+      emitLoad(EAX, false, op.b);
+      emitByte(0x99); // cdq
+      emitAluMem(0xf7, 7, op.c); // idiv dword [c]
+      emitStore(false, op.a, EAX);
+      break;
+    case H_NOT:
+      emitLoad(EAX, false, op.b);
+      emitByte(0xf7); emitByte(0xd0); // not eax
+      emitStore(false, op.a, EAX);
+      break;
+    case H_SHL: case H_SHR:
+      emitLoad(EAX, false, op.b);
+      emitLoad(ECX, false, op.c);
+      emitByte(0xd3); emitByte(op.handler == H_SHL ? 0xe0 : 0xf8); // shl/sar eax, cl
+      emitStore(false, op.a, EAX);
+      break;
+    case H_XCHG:
+      emitLoad(EAX, false, op.b);
+      emitLoad(ECX, false, op.c);
+      emitStore(false, op.b, ECX);
+      emitStore(false, op.c, EAX);
+      break;
+    case H_CSRRD:
+      emitLoad(EAX, true, op.b);
+      emitStore(false, op.a, EAX);
+      break;
+    case H_LD_B_D:
+      emitLoad(EAX, false, op.b);
+      emitAddImmediate(EAX, op.d);
+      emitStore(false, op.a, EAX);
+      break;
+    case H_LD_MEM_B_C_D:
+      emitLoad(ESI, false, op.b);
+      emitAluMem(0x03, ESI, op.c);
+      emitAddImmediate(ESI, op.d);
+      emitReadCall();
+      emitStore(false, op.a, EAX);
+      break;
+    case H_LD_LITERAL:
+      emitMovImmediate(ESI, op.d);
+      emitAluMem(0x03, ESI, op.c);
+      emitReadCall();
+      emitStore(false, op.a, EAX);
+      break;
+    case H_POP:
+      emitLoad(ESI, false, op.b);
+      emitReadCall();
+      emitStore(false, op.a, EAX);
+      emitLoad(EAX, false, op.b);
+      emitAddImmediate(EAX, op.d);
+      emitStore(false, op.b, EAX);
+      break;
+    case H_PUSH:
+      emitLoad(EAX, false, op.a);
+      emitAddImmediate(EAX, op.d);
+      emitStore(false, op.a, EAX);
+      emitLoad(ESI, false, op.c);
+      emitLoad(EDX, false, op.a);
+      emitWriteCall();
+      emitExitIfCodeModified(op, index);
+      break;
+    case H_LD_LITERAL_PUSH:
+      emitMovImmediate(ESI, op.d);
+      emitAluMem(0x03, ESI, op.c);
+      emitReadCall();
+      emitStore(false, op.a, EAX);
+      emitLoad(EAX, false, op.b);
+      emitAddImmediate(EAX, op.e);
+      emitStore(false, op.b, EAX);
+      emitLoad(ESI, false, op.a);
+      emitLoad(EDX, false, op.b);
+      emitWriteCall();
+      emitExitIfCodeModified(op, index);
+      break;
+    case H_ST_MEM:
+      emitLoad(EDX, false, op.a);
+      emitAluMem(0x03, EDX, op.b);
+      emitAddImmediate(EDX, op.d);
+      emitLoad(ESI, false, op.c);
+      emitWriteCall();
+      emitExitIfCodeModified(op, index);
+      break;
+    case H_ST_MEM_MEM:
+      emitLoad(ESI, false, op.a);
+      emitAluMem(0x03, ESI, op.b);
+      emitAddImmediate(ESI, op.d);
+      emitReadCall();
+      emitByte(0x89); emitByte(0xc2); // mov edx, eax
+      emitLoad(ESI, false, op.c);
+      emitWriteCall();
+      emitExitIfCodeModified(op, index);
+      break;
+    case H_SYNC_PC:
+      emitStorePc(op.nextPc);
+      break;
+    case H_CALL_MEM_A_B_D:
+      emitStorePc(op.nextPc);
+      emitLoad(EDX, false, SP);
+      emitAddImmediate(EDX, -4);
+      emitStore(false, SP, EDX);
+      emitLoad(ESI, false, PC);
+      emitWriteCall();
+      emitLoad(ESI, false, op.a);
+      emitAluMem(0x03, ESI, op.b);
+      emitAddImmediate(ESI, op.d);
+      emitReadCall();
+      emitStore(false, PC, EAX);
+      emitExit(index, 0);
+      break;
+    case H_JMP_MEM_A_D:
+      emitStorePc(op.nextPc);
+      emitLoad(ESI, false, op.a);
+      emitAddImmediate(ESI, op.d);
+      emitReadCall();
+      emitStore(false, PC, EAX);
+      emitExit(index, 0);
+      break;
+    case H_BEQ_MEM_A_D: case H_BNE_MEM_A_D: case H_BGT_MEM_A_D: {
+      emitStorePc(op.nextPc);
+      emitLoad(EAX, false, op.b);
+      emitAluMem(0x3b, EAX, op.c); // cmp eax, [c]
+      // skip the taken path when the condition does not hold
+      unsigned char condition = op.handler == H_BEQ_MEM_A_D ? CC_NE : op.handler == H_BNE_MEM_A_D ? CC_E : CC_LE;
+      size_t notTaken = emitJccForward(condition);
+      emitLoad(ESI, false, op.a);
+      emitAddImmediate(ESI, op.d);
+      emitReadCall();
+      emitStore(false, PC, EAX);
+      emitExit(index, 0);
+      patchJump(notTaken);
+      emitExit(index, 1);
+      break;
+    }
+    case H_EXIT:
+      emitStorePc(op.nextPc);
+      emitExit(index, 1);
+      break;
+    case H_EXIT_DYNAMIC:
+      emitExit(index, 0);
+      break;
+    default:
+      break;
+  }
+}
+
+void Jit::emitByte(unsigned char b) {
+  code.push_back(b);
+}
+
+void Jit::emitWord(unsigned int w) {
+  for (int i = 0; i < 4; i++) code.push_back((w >> (8 * i)) & 0xff);
+}
+
+// ModRM with [rbx + disp8] for gp_regs, [r13 + disp8] for cs_regs
+void Jit::emitLoad(int reg, bool csr, int index) {
+  if (csr) emitByte(0x41);
+  emitByte(0x8b);
+  emitByte(0x40 | (reg << 3) | (csr ? 5 : 3));
+  emitByte(index * 4);
+}
+
+void Jit::emitStore(bool csr, int index, int reg) {
+  if (csr) emitByte(0x41);
+  emitByte(0x89);
+  emitByte(0x40 | (reg << 3) | (csr ? 5 : 3));
+  emitByte(index * 4);
+}
+
+void Jit::emitAluMem(unsigned char opcode, int reg, int index) {
+  emitByte(opcode);
+  emitByte(0x40 | (reg << 3) | 3);
+  emitByte(index * 4);
+}
+
+void Jit::emitAddImmediate(int reg, unsigned int imm) {
+  if (imm == 0) return;
+  emitByte(0x81);
+  emitByte(0xc0 | reg);
+  emitWord(imm);
+}
+
+void Jit::emitMovImmediate(int reg, unsigned int imm) {
+  emitByte(0xb8 + reg);
+  emitWord(imm);
+}
+
+void Jit::emitStorePc(unsigned int pc) {
+  // mov dword [rbx + 4 * PC], imm32
+  emitByte(0xc7);
+  emitByte(0x43);
+  emitByte(PC * 4);
+  emitWord(pc);
+}
+
+void Jit::emitCall(const void* function) {
+  const unsigned char setup[] = {0x4c, 0x89, 0xe7, 0x48, 0xb8}; // mov rdi, r12; mov rax, imm64
+  code.insert(code.end(), setup, setup + sizeof(setup));
+  unsigned long long address = (unsigned long long)function;
+  for (int i = 0; i < 8; i++) code.push_back((address >> (8 * i)) & 0xff);
+  emitByte(0xff); emitByte(0xd0); // call rax
+}
+
+// address in esi, result in eax
+void Jit::emitReadCall() {
+  emitCall((const void*)&Emulator::jitReadFourBytes);
+}
+
+// data in esi, address in edx, eax != 0 if translated code was overwritten
+void Jit::emitWriteCall() {
+  emitCall((const void*)&Emulator::jitWriteFourBytes);
+}
+
+void Jit::emitExit(unsigned int index, int slot) {
+  emitMovImmediate(EAX, (index << 1) | slot);
+  const unsigned char epilogue[] = {0x41, 0x5d, 0x41, 0x5c, 0x5b, 0xc3}; // pop r13; pop r12; pop rbx; ret
+  code.insert(code.end(), epilogue, epilogue + sizeof(epilogue));
+}
+
+void Jit::emitExitIfCodeModified(const MicroOp& op, unsigned int index) {
+  emitByte(0x85); emitByte(0xc0); // test eax, eax
+  size_t notModified = emitJccForward(CC_E);
+  emitStorePc(op.nextPc);
+  emitExit(index, 1);
+  patchJump(notModified);
+}
+
+size_t Jit::emitJccForward(unsigned char condition) {
+  emitByte(0x0f);
+  emitByte(0x80 | condition);
+  size_t position = code.size();
+  emitWord(0);
+  return position;
+}
+
+void Jit::patchJump(size_t position) {
+  unsigned int offset = code.size() - (position + 4);
+  for (int i = 0; i < 4; i++) code[position + i] = (offset >> (8 * i)) & 0xff;
+}
@@ -0,0 +1,157 @@
+#include "../inc/link_cache.hpp"
+#include "../inc/object_file.hpp"
+#include <fstream>
+#include <cstring>
+
+// FNV-1a, 64 bits
+unsigned long long hashBytes(const char* data, size_t size) {
+  unsigned long long hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ (unsigned char)data[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+static void writeInt(std::ofstream& output, int value) {
+  output.write((const char*)&value, sizeof(int));
+}
+
+static void writeString(std::ofstream& output, const std::string& str) {
+  writeInt(output, str.length());
+  output.write(str.c_str(), str.length());
+}
+
+static bool readString(ByteReader& reader, std::string& str) {
+  std::string_view view;
+  if (!reader.readString(view)) return false;
+  str = std::string(view);
+  return true;
+}
+
+bool LinkCache::write(const std::string& file) const {
+  std::ofstream output(file, std::ios::binary);
+  if (!output) return false;
+
+  output.write(LINK_CACHE_MAGIC, sizeof(LINK_CACHE_MAGIC) - 1);
+  writeString(output, options);
+
+  writeInt(output, inputs.size());
+  for (int i = 0; i < inputs.size(); i++) {
+    writeString(output, inputs.at(i).file);
+    output.write((const char*)&inputs.at(i).hash, sizeof(inputs.at(i).hash));
+    writeInt(output, inputs.at(i).parts.size());
+    for (int j = 0; j < inputs.at(i).parts.size(); j++) {
+      const CachedPart& part = inputs.at(i).parts.at(j);
+      writeString(output, part.section);
+      writeInt(output, part.length);
+      writeInt(output, part.sectionIndex);
+      writeInt(output, part.offset);
+    }
+  }
+
+  writeInt(output, sections.size());
+  for (int i = 0; i < sections.size(); i++) {
+    writeString(output, sections.at(i).name);
+    writeInt(output, sections.at(i).address);
+    writeInt(output, sections.at(i).length);
+  }
+
+  writeInt(output, symbols.size());
+  for (int i = 0; i < symbols.size(); i++) {
+    writeString(output, symbols.at(i).name);
+    writeInt(output, symbols.at(i).fileId);
+    writeInt(output, symbols.at(i).value);
+    output.write(&symbols.at(i).kind, 1);
+  }
+
+  writeInt(output, sites.size());
+  output.write((const char*)sites.data(), sites.size() * sizeof(CachedSite));
+  return (bool)output;
+}
+
+bool LinkCache::read(const std::string& file) {
+  MappedFile mapped;
+  if (!mapped.open(file)) return false;
+  ByteReader reader(mapped.data(), mapped.size());
+
+  std::string_view magic;
+  if (!reader.readBytes(sizeof(LINK_CACHE_MAGIC) - 1, magic) || magic != LINK_CACHE_MAGIC) return false;
+  readString(reader, options);
+
+  int count = 0;
+  reader.readInt(count);
+  inputs.assign(reader.ok() && count > 0 ? count : 0, CachedInput());
+  for (int i = 0; i < inputs.size() && reader.ok(); i++) {
+    std::string_view hash;
+    readString(reader, inputs.at(i).file);
+    if (reader.readBytes(sizeof(inputs.at(i).hash), hash)) memcpy(&inputs.at(i).hash, hash.data(), hash.size());
+
+    int parts = 0;
+    reader.readInt(parts);
+    for (int j = 0; j < parts && reader.ok(); j++) {
+      CachedPart part;
+      readString(reader, part.section);
+      reader.readInt(part.length);
+      reader.readInt(part.sectionIndex);
+      reader.readInt(part.offset);
+      inputs.at(i).parts.push_back(part);
+    }
+  }
+
+  reader.readInt(count);
+  for (int i = 0; i < count && reader.ok(); i++) {
+    CachedSection section;
+    readString(reader, section.name);
+    reader.readInt(section.address);
+    reader.readInt(section.length);
+    sections.push_back(section);
+  }
+
+  reader.readInt(count);
+  for (int i = 0; i < count && reader.ok(); i++) {
+    CachedSymbol symbol;
+    std::string_view kind;
+    readString(reader, symbol.name);
+    reader.readInt(symbol.fileId);
+    reader.readInt(symbol.value);
+    if (reader.readBytes(1, kind)) symbol.kind = kind[0];
+    symbols.push_back(symbol);
+  }
+
+  std::string_view contents;
+  reader.readInt(count);
+  if (count < 0 || !reader.readBytes((size_t)count * sizeof(CachedSite), contents)) return false;
+  sites.resize(count);
+  memcpy(sites.data(), contents.data(), contents.size());
+
+  if (!reader.ok() || reader.getPosition() != mapped.size()) return false;
+
+  // indices come from the file, check them once here
+  for (int i = 0; i < inputs.size(); i++) {
+    for (int j = 0; j < inputs.at(i).parts.size(); j++) {
+      const CachedPart& part = inputs.at(i).parts.at(j);
+      if (part.sectionIndex < 0 || part.sectionIndex >= sections.size() || part.offset < 0
+          || part.length < 0 || part.offset + part.length > sections.at(part.sectionIndex).length) return false;
+    }
+  }
+  for (int i = 0; i < sites.size(); i++) {
+    const CachedSite& site = sites.at(i);
+    if (site.fileId < 0 || site.fileId >= inputs.size() || site.sectionIndex < 0 || site.sectionIndex >= sections.size()
+        || site.symbol < 0 || site.symbol >= symbols.size() || site.offset < 0
+        || site.offset > sections.at(site.sectionIndex).length - (int)sizeof(int)) return false;
+  }
+  return true;
+}
+
+// .lnk layout: number of sections, then address, length and contents of each one
+long long LinkCache::imageOffset(int sectionIndex) const {
+  long long offset = sizeof(int);
+  for (int i = 0; i < sectionIndex; i++) {
+    offset += 2 * sizeof(int) + sections.at(i).length;
+  }
+  return offset + 2 * sizeof(int);
+}
+
+long long LinkCache::imageSize() const {
+  return imageOffset(sections.size()) - 2 * sizeof(int);
+}
@@ -1,332 +1,423 @@
 #include "../inc/linker.hpp"
+#include "../inc/image_writer.hpp"
+#include "../inc/thread_pool.hpp"
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 Linker::Linker() {
   this->outfileStr = "";
   this->isHex = false;
+  this->threads = 0;
+  this->incremental = false;
+  this->gcSections = false;
+  this->entrySymbol = "";
 }
 
-void Linker::analizeInputFiles() {
-  for (int i = 0; i < inputFiles.size(); i++) {
-    //std::cout << "FILE : " << inputFiles.at(i) << "\n";
-    std::string infileStr = inputFiles.at(i);
-    std::ifstream file(infileStr, std::ios::in | std::ios::binary);
-
-    // symbol table
-    int numOfEntries = 0;
-    file.read((char*)&numOfEntries, sizeof(int));
-    for (int j = 0; j < numOfEntries; j++) {
-      SymbolTableEntry entry;
-      entry.fileId = i;
-
-      int len;
-      file.read((char*)&len, sizeof(int));
-      entry.name.resize(len);
-      file.read((char*)entry.name.c_str(), len);
-
-      file.read((char*)&entry.isDefined, sizeof(entry.isDefined));
-      file.read((char*)&entry.isGlobal, sizeof(entry.isGlobal));
-      file.read((char*)&entry.isExtern, sizeof(entry.isExtern));
-      file.read((char*)&entry.value, sizeof(entry.value));
-
-      file.read((char*)&len, sizeof(int));
-      entry.section.resize(len);
-      
-      file.read((char*)entry.section.c_str(), len);
+// Archives are set aside, their members become inputs only once something needs them.
+bool Linker::analizeInputFiles() {
+  std::vector<std::string> arguments;
+  arguments.swap(inputFiles);
+  mappedFiles.clear(); // left by an incremental relink that could not be done
+
+  bool valid = true;
+  for (int a = 0; a < arguments.size(); a++) {
+    mappedFiles.emplace_back(new MappedFile());
+    MappedFile& mapped = *mappedFiles.back();
+    if (!mapped.open(arguments.at(a))) {
+      std::cout << "could not read input file '" << arguments.at(a) << "': cannot open the file.\n";
+      valid = false;
+      continue;
+    }
 
-        // if symbol is local, just add it to symbolTable for corresponding file
-        // else if symbol is global, add it to corresponding symbolTable, but also add it to globalSymbolTable
-      if (!entry.isGlobal && !entry.isExtern && entry.isDefined) {
-        symbolTablesForEachFile[infileStr].push_back(entry);
-      } else if (entry.isDefined) {
-        globalSymbolTable.push_back(entry);
-        auto it = symbolTimesDefined.find(entry.name);
-        if (it != symbolTimesDefined.end()) {
-          symbolTimesDefined[entry.name]++;
-        } else {
-          symbolTimesDefined[entry.name] = 1;
-        }
+    if (Archive::isArchive(mapped.data(), mapped.size())) {
+      Archive archive;
+      if (!archive.read(mapped.data(), mapped.size())) {
+        std::cout << "could not read archive '" << arguments.at(a) << "': " << archive.getError() << ".\n";
+        valid = false;
+        continue;
       }
-      // If symbol not defined in a file, we discard the symbol entry.
+      archives.push_back(std::make_pair(arguments.at(a), archive));
+    } else {
+      inputFiles.push_back(arguments.at(a));
+      inputContents.push_back(std::string_view(mapped.data(), mapped.size()));
     }
-    // section table
-    file.read((char*)&numOfEntries, sizeof(int));
-    for (int j = 0; j < numOfEntries; j++) {
-      SectionTableEntry entry;
-
-      entry.offset = 0;
-
-      int len;
-      file.read((char*)&len, sizeof(int));
-      entry.name.resize(len);
-      file.read((char*)entry.name.c_str(), len);
-      
-      file.read((char*)&entry.id, sizeof(entry.id));
-      file.read((char*)&entry.length, sizeof(entry.length));
+  }
+  if (!valid || !loadInputFiles(0)) return false;
+  return archives.empty() || extractArchiveMembers();
+}
 
-      
+// Files from first on are parsed in parallel into their own tables, names are then interned and
+// symbols indexed serially in input order, so the result does not depend on the thread count.
+bool Linker::loadInputFiles(int first) {
+  symbolTablesForEachFile.resize(inputFiles.size());
+  sectionTableForEachFile.resize(inputFiles.size());
+  relocTableForEachFile.resize(inputFiles.size());
+  inputHashes.resize(inputFiles.size());
+
+  std::vector<std::vector<SymbolTableEntry>> symbolsForEachFile(inputFiles.size());
+  std::vector<std::string> errors(inputFiles.size());
+  ThreadPool pool(threads);
+  for (int i = first; i < inputFiles.size(); i++) {
+    pool.submit([this, i, &symbolsForEachFile, &errors]() { readInputFile(i, symbolsForEachFile.at(i), errors.at(i)); });
+  }
+  pool.run();
 
-      sectionTableForEachFile[infileStr].push_back(entry);
+  bool valid = true;
+  for (int i = first; i < inputFiles.size(); i++) {
+    if (errors.at(i) != "") {
+      std::cout << "could not read input file '" << inputFiles.at(i) << "': " << errors.at(i) << ".\n";
+      valid = false;
     }
-    // reloc table
-    file.read((char*)&numOfEntries, sizeof(int));
-    for (int j = 0; j < numOfEntries; j++) {
-      RelocationTableEntry entry;
-      int len;
-
-      file.read((char*)&len, sizeof(int));
-      entry.section.resize(len);
-      file.read((char*)entry.section.c_str(), len);
-
-      file.read((char*)&entry.offset, sizeof(entry.offset));
-      file.read((char*)&entry.type, sizeof(entry.type));
-
-      file.read((char*)&len, sizeof(int));
-      entry.symbol.resize(len);
-      file.read((char*)entry.symbol.c_str(), len);
+  }
+  if (!valid) return false;
 
-      file.read((char*)&entry.addend, sizeof(entry.addend));
+  for (int i = first; i < inputFiles.size(); i++) {
+    for (int j = 0; j < sectionTableForEachFile[i].size(); j++) {
+      SectionTableEntry& entry = sectionTableForEachFile[i].at(j);
+      entry.nameId = strings.intern(entry.name);
+    }
 
+    for (int j = 0; j < symbolsForEachFile.at(i).size(); j++) {
+      SymbolTableEntry& entry = symbolsForEachFile.at(i).at(j);
+      entry.nameId = strings.intern(entry.name);
 
-      relocTableForEachFile[infileStr].push_back(entry);
+        // if symbol is local, just add it to symbolTable for corresponding file
+        // else if symbol is global, add it to corresponding symbolTable, but also add it to globalSymbolTable
+      if (!entry.isGlobal && !entry.isExtern && entry.isDefined) {
+        symbolIndex.insert(i, entry.nameId, symbolTablesForEachFile[i].size());
+        symbolTablesForEachFile[i].push_back(entry);
+      } else if (entry.isDefined) {
+        if (!symbolIndex.insert(GLOBAL_SCOPE, entry.nameId, globalSymbolTable.size())) {
+          multiplyDefinedSymbols.push_back(std::string(entry.name));
+        }
+        globalSymbolTable.push_back(entry);
+      }
+      // If symbol not defined in a file, we discard the symbol entry.
     }
-    // sections data
-    file.read((char*)&numOfEntries, sizeof(int));
-    
-    for (int j = 0; j < numOfEntries; j++) {
-      int len;
-      std::string section;
-      std::string data;
-      file.read((char*)&len, sizeof(int));
-      section.resize(len);
-      file.read((char*)section.c_str(), len);
-
-      file.read((char*)&len, sizeof(int));
-      data.resize(len);
-      file.read((char*)data.c_str(), len);
-
-      // append data to section
-      stringstreamPerSectionPerFile[infileStr][section].write((char*)data.c_str(), len);
+
+    for (int j = 0; j < relocTableForEachFile[i].size(); j++) {
+      RelocationTableEntry& entry = relocTableForEachFile[i].at(j);
+      entry.symbolId = strings.intern(entry.symbol);
     }
-    file.close();
   }
+  return true;
 }
 
-// If two files have a section with same name, the section of the second
-// file will have an offset of sectionFromFirstFile.length
-void Linker::determineSectionOffsetsFromFirstInstanceOfSection() {
-  // No need to change offsets from first file, because they will always be zero.
-  for (int i = 0; i < inputFiles.size(); i++) {
-    
-    std::string currFile = inputFiles.at(i);
-
-    for (int j = 0; j < sectionTableForEachFile[currFile].size(); j++) {
-      std::string currSectionName = sectionTableForEachFile[currFile].at(j).name;
-      int currOffset = 0;
-      bool found = false;
-      for (int k = i - 1; k >= 0; k--) {
-        std::string fileToCheck = inputFiles.at(k);
-
-        for (int p = 0; p < sectionTableForEachFile[fileToCheck].size(); p++) {
-          if (sectionTableForEachFile[fileToCheck].at(p).name == currSectionName) {
-            sectionTableForEachFile[currFile].at(j).offset = sectionTableForEachFile[fileToCheck].at(p).length
-                                                            + sectionTableForEachFile[fileToCheck].at(p).offset;
-            found = true;
-            sectionTableForEachFile[fileToCheck].at(p).hasFollowUp = true; // the internal structure that tells if
-                                                          // the section has a follow up section from another file.
-            break;
-          } 
+// Each round extracts the members defining a global that the inputs so far refer to and nobody
+// defines, searching the archives in command line order. The new members can refer to more
+// globals, so rounds go on until one adds nothing. A name is looked up in the indices once:
+// it is either found and its member extracted, or no archive has it.
+bool Linker::extractArchiveMembers() {
+  std::vector<std::vector<char>> extracted(archives.size());
+  for (int a = 0; a < archives.size(); a++) {
+    extracted.at(a).assign(archives.at(a).second.members.size(), false);
+  }
+  std::vector<char> lookedUp;
+  std::vector<int> wanted; // name ids
+
+  // the entry symbol may live in an archive too
+  if (entrySymbol != "") wanted.push_back(strings.intern(entrySymbol));
+
+  int scanned = 0;
+  while (true) {
+    for (int i = scanned; i < inputFiles.size(); i++) {
+      for (int j = 0; j < relocTableForEachFile[i].size(); j++) {
+        int symbolId = relocTableForEachFile[i].at(j).symbolId;
+        if (symbolIndex.find(i, symbolId) == -1) wanted.push_back(symbolId);
+      }
+    }
+    scanned = inputFiles.size();
+    lookedUp.resize(strings.size(), false);
+
+    for (int w = 0; w < wanted.size(); w++) {
+      int nameId = wanted.at(w);
+      if (lookedUp.at(nameId) || symbolIndex.find(GLOBAL_SCOPE, nameId) != -1) continue;
+      lookedUp.at(nameId) = true;
+
+      for (int a = 0; a < archives.size(); a++) {
+        const Archive& archive = archives.at(a).second;
+        int member = archive.findSymbol(strings.at(nameId));
+        if (member == -1) continue;
+        if (!extracted.at(a).at(member)) {
+          extracted.at(a).at(member) = true;
+          inputFiles.push_back(archives.at(a).first + "(" + std::string(archive.members.at(member).name) + ")");
+          inputContents.push_back(archive.members.at(member).contents);
         }
-        if (found == true) break;
+        break;
       }
     }
+    wanted.clear();
+
+    if (scanned == inputFiles.size()) return true;
+    if (!loadInputFiles(scanned)) return false;
   }
 }
 
-void Linker::updateOffsetsOfTables() {
-
-  // no need to change tables from first file, because offsets of sections will always be zero.
-  for (int i = 1; i < inputFiles.size(); i++) {
-    std::string currFile = inputFiles.at(i);
+// Runs on a worker thread: only touches the tables of file i and symbols, names are not interned yet.
+// The tables point into the file's mapping.
+bool Linker::readInputFile(int i, std::vector<SymbolTableEntry>& symbols, std::string& error) {
+  std::string_view contents = inputContents.at(i);
+  if (incremental) inputHashes.at(i) = hashBytes(contents.data(), contents.size());
 
-    // updateSymbolTables(), because value (or offset from start of section) may now be obsolete and should be updated
-    for (int j = 0; j < symbolTablesForEachFile[currFile].size(); j++) {
-      //std::cout << "> " << symbolTablesForEachFile[currFile].at(j).name << " " << symbolTablesForEachFile[currFile].at(j).value << '\n';
-
-      for (int k = 0; k < sectionTableForEachFile[currFile].size(); k++) {
-        if (sectionTableForEachFile[currFile].at(k).name == symbolTablesForEachFile[currFile].at(j).section) {
-          symbolTablesForEachFile[currFile].at(j).value = symbolTablesForEachFile[currFile].at(j).value + sectionTableForEachFile[currFile].at(k).offset;
-          break;
-        }
-      }
-      //std::cout << ">! " << symbolTablesForEachFile[currFile].at(j).name << " " << symbolTablesForEachFile[currFile].at(j).value << '\n';
+  ObjectFile object;
+  if (!object.read(contents.data(), contents.size())) {
+    error = object.getError();
+    return false;
+  }
 
-    }
+  for (int j = 0; j < object.sections.size(); j++) {
+    const ObjectSection& section = object.sections.at(j);
+    SectionTableEntry entry;
+    entry.id = section.id;
+    entry.name = section.name;
+    entry.offset = 0;
+    entry.length = section.length;
+    entry.fileId = i;
+    entry.mergedId = -1;
+    entry.live = true;
+    entry.data = section.data;
+    sectionTableForEachFile[i].push_back(entry);
   }
-    // updateGlobalSymbolTable()
-  for (int j = 0; j < globalSymbolTable.size(); j++) {
-    std::string currFile = inputFiles.at(globalSymbolTable.at(j).fileId);
-    //std::cout << "< " << globalSymbolTable.at(j).name << " " << globalSymbolTable.at(j).value << '\n';
 
-    for (int k = 0; k < sectionTableForEachFile[currFile].size(); k++) {
-      if (sectionTableForEachFile[currFile].at(k).name == globalSymbolTable.at(j).section) {
-        globalSymbolTable.at(j).value = globalSymbolTable.at(j).value + sectionTableForEachFile[currFile].at(k).offset;
-      }
-    }
-    //std::cout << "<! " << globalSymbolTable.at(j).name << " " << globalSymbolTable.at(j).value << '\n';
+  for (int j = 0; j < object.symbols.size(); j++) {
+    const ObjectSymbol& symbol = object.symbols.at(j);
+    SymbolTableEntry entry;
+    entry.name = symbol.name;
+    entry.value = symbol.value;
+    entry.isGlobal = symbol.isGlobal;
+    entry.isExtern = symbol.isExtern;
+    entry.isDefined = symbol.isDefined;
+    entry.sectionIndex = object.findSection(symbol.section);
+    entry.fileId = i;
+    symbols.push_back(entry);
   }
-  // updateRelocTables(), because offset (from start of section) may now be obsolete and should be updated
-  for (int i = 0; i < inputFiles.size(); i++) {
-    std::string currFile = inputFiles.at(i);
-    for (int j = 0; j < relocTableForEachFile[currFile].size(); j++) {
-      
-      for (int k = 0; k < sectionTableForEachFile[currFile].size(); k++) {
-        if (sectionTableForEachFile[currFile].at(k).name == relocTableForEachFile[currFile].at(j).section) {
-          relocTableForEachFile[currFile].at(j).offset = relocTableForEachFile[currFile].at(j).offset + sectionTableForEachFile[currFile].at(k).offset;
-        }
-      }
-    }
+
+  for (int j = 0; j < object.relocations.size(); j++) {
+    const ObjectRelocation& relocation = object.relocations.at(j);
+    RelocationTableEntry entry;
+    entry.sectionIndex = object.findSection(relocation.section);
+    entry.offset = relocation.offset;
+    entry.type = (RELOC_TYPE)relocation.type;
+    entry.symbol = relocation.symbol;
+    entry.addend = relocation.addend;
+    relocTableForEachFile[i].push_back(entry);
   }
+  return true;
 }
 
-void Linker::mergeSectionStringstreams() {
+// One merged section per section name. Parts are placed one after another in input file order,
+// so each part's offset is the sum of the lengths of the parts before it.
+void Linker::indexSections() {
+  mergedSectionOfName.assign(strings.size(), -1);
 
   for (int i = 0; i < inputFiles.size(); i++) {
-    std::string currFile = inputFiles.at(i);
+    for (int j = 0; j < sectionTableForEachFile[i].size(); j++) {
+      SectionTableEntry& section = sectionTableForEachFile[i].at(j);
+      if (!section.live) continue;
+
+      int& mergedId = mergedSectionOfName.at(section.nameId);
+      if (mergedId == -1) {
+        mergedId = mergedSections.size();
+        MergedSection merged;
+        merged.name = std::string(section.name);
+        merged.offset = 0;
+        merged.length = 0;
+        mergedSections.push_back(merged);
+      }
 
-    for (int j = 0; j < sectionTableForEachFile[currFile].size(); j++) {
-      std::string currSection = sectionTableForEachFile[currFile].at(j).name;
-      std::string currString = stringstreamPerSectionPerFile[currFile][currSection].str();
-      int len = currString.length();
-      stringstreamPerMergedSection[currSection].write((char*)currString.c_str(), len);
+      MergedSection& merged = mergedSections.at(mergedId);
+      section.mergedId = mergedId;
+      section.offset = merged.length;
+      merged.length += section.length;
+      merged.parts.push_back(std::make_pair(i, j));
     }
   }
 }
 
-void Linker::determineSectionLengths() {
+int Linker::findMergedSection(const std::string& name) {
+  int nameId = strings.find(name);
+  if (nameId == -1 || nameId >= mergedSectionOfName.size()) return -1;
+  return mergedSectionOfName.at(nameId);
+}
 
-  for (int i = 0; i < inputFiles.size(); i++) {
-    std::string currFile = inputFiles.at(i);
-
-    for (int j = 0; j < sectionTableForEachFile[currFile].size(); j++) {
-      //std::cout << " >>  " << sectionTableForEachFile[currFile].at(j).name << " " << sectionTableForEachFile[currFile].at(j).offset <<" " << sectionTableForEachFile[currFile].at(j).length << "\n";
-
-      if (sectionTableForEachFile[currFile].at(j).hasFollowUp == true) {
-        for (int k = i + 1; k < inputFiles.size(); k++) {
-          std::string nextFile = inputFiles.at(k);
-          bool hasAnotherFollowUp = false;
-
-          int deletedSections = 0;
-          for (int p = 0; p < sectionTableForEachFile[nextFile].size(); p++) {
-
-            if (sectionTableForEachFile[nextFile].at(p).name == sectionTableForEachFile[currFile].at(j).name) {
-              sectionTableForEachFile[currFile].at(j).length = sectionTableForEachFile[currFile].at(j).length + sectionTableForEachFile[nextFile].at(p).length;
-              hasAnotherFollowUp = sectionTableForEachFile[nextFile].at(p).hasFollowUp;
-              // i could also, when i update structures from currSection, delete nextSection because the sectionTableEntry for
-              // the nextSection is no longer needed
-              sectionTableForEachFile[nextFile].erase(sectionTableForEachFile[nextFile].begin() + p - deletedSections);
-              deletedSections++; // because we shrinked sectionTable for 1 element (balances out the p++ in for loop)
-              break;
-            }
-          }
-          if (hasAnotherFollowUp == false) break;
-        }
-      }
+// Merged sections go one after another into the image, in address order. Each file's part
+// is copied straight from its mapping to its final place, parts without contents stay zero.
+void Linker::buildImage() {
+  size_t imageSize = 0;
+  for (int i = 0; i < sectionsByAddress.size(); i++) {
+    MergedSection& merged = mergedSections.at(sectionsByAddress.at(i));
+    merged.imageOffset = imageSize;
+    imageSize += merged.length;
+  }
+  image.assign(imageSize, 0);
+
+  for (int i = 0; i < mergedSections.size(); i++) {
+    for (int j = 0; j < mergedSections.at(i).parts.size(); j++) {
+      std::pair<int, int> part = mergedSections.at(i).parts.at(j);
+      const SectionTableEntry& section = sectionTableForEachFile[part.first].at(part.second);
+      size_t length = section.data.length() < (size_t)section.length ? section.data.length() : section.length;
+      memcpy(image.data() + mergedSections.at(i).imageOffset + section.offset, section.data.data(), length);
     }
   }
 }
 
+// Placed sections go where they were asked to, the rest follow the highest placed one
+// in order of first appearance.
 void Linker::determineSectionOffsetsFromStartOfProgram() {
   int currMaxOffset = 0;
-  //std::cout << '\n' << sectionsWithPlaceOption.size() << '\n';
   for (int i = 0; i < sectionsWithPlaceOption.size(); i++) {
-    std::string placedSectionName = sectionsWithPlaceOption.at(i).first;
-    int place = sectionsWithPlaceOption.at(i).second;
-    //std::cout << placedSectionName << ":" << place << "\n";
-    for (int j = 0; j < inputFiles.size(); j++) {
-      std::string currFile = inputFiles.at(j);
-      bool found = false;
-
-      for (int k = 0; k < sectionTableForEachFile[currFile].size(); k++) {
-        //std::cout << " >>  " << sectionTableForEachFile[currFile].at(k).name << "\n";
-        if (sectionTableForEachFile[currFile].at(k).name == placedSectionName) {
-          sectionTableForEachFile[currFile].at(k).offset = place;
-          sectionTableForEachFile[currFile].at(k).hasExplicitPlace = true;
-          int possibleMaxOffset = place + sectionTableForEachFile[currFile].at(k).length;
-          if (possibleMaxOffset > currMaxOffset) currMaxOffset = possibleMaxOffset; 
-          found = true;
-          break;
-        }
-      }
-      if (found == true) break;
-    }
+    int mergedId = findMergedSection(sectionsWithPlaceOption.at(i).first);
+    if (mergedId == -1) continue;
+
+    MergedSection& merged = mergedSections.at(mergedId);
+    merged.offset = sectionsWithPlaceOption.at(i).second;
+    merged.hasExplicitPlace = true;
+    int possibleMaxOffset = merged.offset + merged.length;
+    if (possibleMaxOffset > currMaxOffset) currMaxOffset = possibleMaxOffset;
+  }
+
+  for (int i = 0; i < mergedSections.size(); i++) {
+    if (mergedSections.at(i).hasExplicitPlace) continue;
+    mergedSections.at(i).offset = currMaxOffset;
+    currMaxOffset += mergedSections.at(i).length;
   }
+}
 
+// Symbol values become offsets from start of program.
+void Linker::determineSymbolValues() {
   for (int i = 0; i < inputFiles.size(); i++) {
-    std::string currFile = inputFiles.at(i);
-
-    for (int j = 0; j < sectionTableForEachFile[currFile].size(); j++) {
-      // if section is explicitly placed. skip this section;
-      if (sectionTableForEachFile[currFile].at(j).hasExplicitPlace == true) continue;
-      sectionTableForEachFile[currFile].at(j).offset = currMaxOffset; // IMPORTANT - NOW offsets determine offset from START OF PROGRAM!!!
-      currMaxOffset += sectionTableForEachFile[currFile].at(j).length;
-      //std::cout << " >>  " << sectionTableForEachFile[currFile].at(j).name << " " << sectionTableForEachFile[currFile].at(j).offset <<" " << sectionTableForEachFile[currFile].at(j).length << "\n";
+    for (int j = 0; j < symbolTablesForEachFile[i].size(); j++) {
+      SymbolTableEntry& symbol = symbolTablesForEachFile[i].at(j);
+      if (symbol.sectionIndex == -1 || isDiscarded(symbol)) continue;
+      const SectionTableEntry& section = sectionTableForEachFile[i].at(symbol.sectionIndex);
+      symbol.value += mergedSections.at(section.mergedId).offset + section.offset;
     }
   }
+
+  for (int j = 0; j < globalSymbolTable.size(); j++) {
+    SymbolTableEntry& symbol = globalSymbolTable.at(j);
+    if (symbol.sectionIndex == -1 || isDiscarded(symbol)) continue;
+    const SectionTableEntry& section = sectionTableForEachFile[symbol.fileId].at(symbol.sectionIndex);
+    symbol.value += mergedSections.at(section.mergedId).offset + section.offset;
+  }
 }
 
-void Linker::determineSymbolAndRelocOffsetsFromStartOfFile() {
-  for (int i = 0; i < inputFiles.size(); i++) {
-    std::string currFileName = inputFiles.at(i);
+bool Linker::isDiscarded(const SymbolTableEntry& symbol) {
+  return symbol.sectionIndex != -1 && !sectionTableForEachFile[symbol.fileId].at(symbol.sectionIndex).live;
+}
 
-    for (int j = 0; j < sectionTableForEachFile[currFileName].size(); j++) {
-      
-      // symbol tables
-      for (int k = 0; k < symbolTablesForEachFile[currFileName].size(); k++) {
-        if (symbolTablesForEachFile[currFileName].at(k).section == sectionTableForEachFile[currFileName].at(j).name) {
-          //std::cout << "> " << symbolTablesForEachFile[currFileName].at(k).name << " " << symbolTablesForEachFile[currFileName].at(k).value << '\n';
-          symbolTablesForEachFile[currFileName].at(k).value += sectionTableForEachFile[currFileName].at(j).offset;
-          //std::cout << "> " << symbolTablesForEachFile[currFileName].at(k).name << " " << symbolTablesForEachFile[currFileName].at(k).value << "\n\n";
+// Marks every section part that can't be reached from the entry symbol's part or the placed
+// sections by following relocations as not live, and reports what that removes.
+bool Linker::collectGarbageSections() {
+  // parts are numbered file by file
+  std::vector<int> firstPart(inputFiles.size() + 1, 0);
+  for (int i = 0; i < inputFiles.size(); i++) {
+    firstPart.at(i + 1) = firstPart.at(i) + sectionTableForEachFile[i].size();
+  }
+  std::vector<std::vector<int>> relocsOfPart(firstPart.back());
+  for (int i = 0; i < inputFiles.size(); i++) {
+    for (int j = 0; j < relocTableForEachFile[i].size(); j++) {
+      int sectionIndex = relocTableForEachFile[i].at(j).sectionIndex;
+      if (sectionIndex != -1) relocsOfPart.at(firstPart.at(i) + sectionIndex).push_back(j);
+    }
+  }
 
-        }
+  std::vector<char> reached(firstPart.back(), false);
+  std::vector<int> work;
+  auto reach = [&](int fileId, int sectionIndex) {
+    if (sectionIndex == -1 || reached.at(firstPart.at(fileId) + sectionIndex)) return;
+    reached.at(firstPart.at(fileId) + sectionIndex) = true;
+    work.push_back(firstPart.at(fileId) + sectionIndex);
+  };
+
+  if (entrySymbol != "") {
+    int nameId = strings.find(entrySymbol);
+    int k = nameId == -1 ? -1 : symbolIndex.find(GLOBAL_SCOPE, nameId);
+    if (k == -1) {
+      std::cout << "entry symbol '" << entrySymbol << "' is not defined.\n";
+      return false;
+    }
+    reach(globalSymbolTable.at(k).fileId, globalSymbolTable.at(k).sectionIndex);
+  }
+  for (int p = 0; p < sectionsWithPlaceOption.size(); p++) {
+    int nameId = strings.find(sectionsWithPlaceOption.at(p).first);
+    for (int i = 0; i < inputFiles.size(); i++) {
+      for (int j = 0; j < sectionTableForEachFile[i].size(); j++) {
+        if (sectionTableForEachFile[i].at(j).nameId == nameId) reach(i, j);
       }
-      
-      // global symbols table
-      for (int k = 0; k < globalSymbolTable.size(); k++) {
-        if (globalSymbolTable.at(k).section == sectionTableForEachFile[currFileName].at(j).name) {
-          //std::cout << ">- " << globalSymbolTable.at(k).name << " " << globalSymbolTable.at(k).value << '\n';
-          globalSymbolTable.at(k).value += sectionTableForEachFile[currFileName].at(j).offset;
-        }
+    }
+  }
+  if (work.empty()) {
+    std::cout << "no entry symbol or placed section to start from, -gc-sections keeps everything.\n";
+    return true;
+  }
+
+  while (!work.empty()) {
+    int part = work.back();
+    work.pop_back();
+    int i = std::upper_bound(firstPart.begin(), firstPart.end(), part) - firstPart.begin() - 1;
+
+    for (int r = 0; r < relocsOfPart.at(part).size(); r++) {
+      const RelocationTableEntry& reloc = relocTableForEachFile[i].at(relocsOfPart.at(part).at(r));
+      int k = symbolIndex.find(i, reloc.symbolId);
+      if (k != -1) {
+        reach(i, symbolTablesForEachFile[i].at(k).sectionIndex);
+        continue;
       }
+      k = symbolIndex.find(GLOBAL_SCOPE, reloc.symbolId);
+      if (k != -1) reach(globalSymbolTable.at(k).fileId, globalSymbolTable.at(k).sectionIndex);
+    }
+  }
+
+  int removedParts = 0;
+  long long removedBytes = 0;
+  for (int i = 0; i < inputFiles.size(); i++) {
+    for (int j = 0; j < sectionTableForEachFile[i].size(); j++) {
+      if (reached.at(firstPart.at(i) + j)) continue;
+      SectionTableEntry& section = sectionTableForEachFile[i].at(j);
+      section.live = false;
+      std::cout << "removing section '" << section.name << "' of '" << inputFiles.at(i) << "' (" << std::dec << section.length << " bytes)\n";
+      removedParts++;
+      removedBytes += section.length;
     }
   }
+  std::cout << "gc-sections removed " << removedBytes << " bytes in " << removedParts << " of " << firstPart.back() << " sections.\n";
+  return true;
 }
 
+// Local symbols of the file take precedence over globals, relocations to undefined symbols
+// (or outside of their section) are left as they are.
 void Linker::relocateSymbolInstances() {
   for (int i = 0; i < inputFiles.size(); i++) {
-    std::string currFileName = inputFiles.at(i);
-
-    for (int j = 0; j < relocTableForEachFile[currFileName].size(); j++) {
+    std::vector<RelocationTableEntry>& relocs = relocTableForEachFile[i];
+    std::vector<SymbolTableEntry>& localSymbols = symbolTablesForEachFile[i];
+
+    for (int j = 0; j < relocs.size(); j++) {
+      RelocationTableEntry& reloc = relocs.at(j);
+      if (reloc.sectionIndex == -1 || !sectionTableForEachFile[i].at(reloc.sectionIndex).live) continue;
+
+      int value;
+      int global = -1;
+      int k = symbolIndex.find(i, reloc.symbolId);
+      if (k != -1) {
+        value = localSymbols.at(k).value;
+      } else {
+        global = symbolIndex.find(GLOBAL_SCOPE, reloc.symbolId);
+        if (global == -1) continue;
+        value = globalSymbolTable.at(global).value;
+      }
 
+      const SectionTableEntry& section = sectionTableForEachFile[i].at(reloc.sectionIndex);
+      if (reloc.offset < 0 || reloc.offset > section.length - (int)sizeof(int)) continue;
+      size_t position = mergedSections.at(section.mergedId).imageOffset + section.offset + reloc.offset;
+      memcpy(image.data() + position, &value, sizeof(int));
 
-      bool isLocal = false;
-      for (int k = 0; k < symbolTablesForEachFile[currFileName].size(); k++) {
-        if (symbolTablesForEachFile[currFileName].at(k).name == relocTableForEachFile[currFileName].at(j).symbol) {
-          //std::cout << "RELOCATING..." << symbolTablesForEachFile[currFileName].at(k).name << "|" << symbolTablesForEachFile[currFileName].at(k).value << "\n";
-          stringstreamPerMergedSection[relocTableForEachFile[currFileName].at(j).section].seekp(relocTableForEachFile[currFileName].at(j).offset);
-          stringstreamPerMergedSection[relocTableForEachFile[currFileName].at(j).section].write((char*)&symbolTablesForEachFile[currFileName].at(k).value, sizeof(int));
-          stringstreamPerMergedSection[relocTableForEachFile[currFileName].at(j).section].seekp(0, std::ios::end);
-          isLocal = true;
-        }
-      }
-      if (!isLocal) {
-        for (int k = 0; k < globalSymbolTable.size(); k++) {
-          if (globalSymbolTable.at(k).name == relocTableForEachFile[currFileName].at(j).symbol) {
-            //std::cout << "RELOCATING(global)..." << globalSymbolTable.at(k).name << "(" << globalSymbolTable.at(k).value << ") ->" << relocTableForEachFile[currFileName].at(j).section << "(" << relocTableForEachFile[currFileName].at(j).offset <<")\n";
-            stringstreamPerMergedSection[relocTableForEachFile[currFileName].at(j).section].seekp(relocTableForEachFile[currFileName].at(j).offset);
-            stringstreamPerMergedSection[relocTableForEachFile[currFileName].at(j).section].write((char*)&globalSymbolTable.at(k).value, sizeof(int));
-            stringstreamPerMergedSection[relocTableForEachFile[currFileName].at(j).section].seekp(0, std::ios::end);
-          }
-        }
+      // section index is the merged one until recordLinkState()
+      if (incremental && global != -1) {
+        CachedSite site = {i, section.mergedId, section.offset + reloc.offset, global};
+        linkState.sites.push_back(site);
       }
     }
   }
@@ -335,41 +426,20 @@ void Linker::relocateSymbolInstances() {
 bool Linker::checkForOverlappedPlaceSections() {
   bool overlapExists = false;
   for (int i = 0; i < sectionsWithPlaceOption.size(); i++) {
-    auto pair1 = sectionsWithPlaceOption.at(i);
-    int len1;
-    for (int j  = 0; j < inputFiles.size(); j++) {
-      bool found = false;
-      std::string currFile = inputFiles.at(j);
-      for (int k = 0; k < sectionTableForEachFile[currFile].size(); k++) {
-        if (sectionTableForEachFile[currFile].at(k).name == pair1.first) {
-          len1 = sectionTableForEachFile[currFile].at(k).length;
-          found = true;
-          break;
-        }
-      }
-      if (found == true) break;
-    }
-    for (int j = 0; j < sectionsWithPlaceOption.size(); j++) {
-      auto pair2 = sectionsWithPlaceOption.at(j);
-      if (pair1.first == pair2.first) continue;
-      int len2;
-      for (int k = 0; k < inputFiles.size(); k++) {
-        bool found = false;
-        std::string currFile = inputFiles.at(k);
-        for (int q = 0; q < sectionTableForEachFile[currFile].size(); q++) {
-          if (sectionTableForEachFile[currFile].at(q).name == pair2.first) {
-            len2 = sectionTableForEachFile[currFile].at(q).length;
-
-            if ((pair1.second < pair2.second && pair1.second + len1 >= pair2.second)
-                  || (pair2.second < pair1.second && pair2.second + len2 >= pair1.second)) {
-              std::cout << "sections used in -place option are overlapping\n";
-              overlapExists = true;
-            }
-
-            found = true;
-            break;
-          }
-        }
+    int first = findMergedSection(sectionsWithPlaceOption.at(i).first);
+    if (first == -1) continue;
+    int start1 = sectionsWithPlaceOption.at(i).second;
+    int len1 = mergedSections.at(first).length;
+
+    for (int j = i + 1; j < sectionsWithPlaceOption.size(); j++) {
+      int second = findMergedSection(sectionsWithPlaceOption.at(j).first);
+      if (second == -1 || second == first) continue;
+      int start2 = sectionsWithPlaceOption.at(j).second;
+      int len2 = mergedSections.at(second).length;
+
+      if (start1 < start2 + len2 && start2 < start1 + len1) {
+        std::cout << "sections used in -place option are overlapping\n";
+        overlapExists = true;
       }
     }
   }
@@ -377,93 +447,97 @@ bool Linker::checkForOverlappedPlaceSections() {
 }
 
 void Linker::mergeSections() {
-  determineSectionOffsetsFromFirstInstanceOfSection();
-  updateOffsetsOfTables(); // to represent offset from start of section it is a part of
-  mergeSectionStringstreams(); // std::maps of sections from each file will now be a part of one std::map of sections
-  
-  determineSectionLengths(); // updates section lengths to sections that existed in more than one file.
-                             // also, if a section existed in more than one file, it deletes all but first instances of
-                             // the section in section table entries
+  indexSections(); // every section name becomes one merged section, made of the parts from each file
 
   bool overlapExists = checkForOverlappedPlaceSections();
-  //std::cout << "\n\n#####";
   determineSectionOffsetsFromStartOfProgram();
-  //std::cout << "#####\n\n";
-  determineSymbolAndRelocOffsetsFromStartOfFile();
-  
+  determineSymbolValues();
+
+  putAndSortSectionsIntoOneVector();
+  buildImage();
   relocateSymbolInstances();
 }
 
 void Linker::putAndSortSectionsIntoOneVector() {
-  for (int i = 0; i < inputFiles.size(); i++) {
-    for (int j = 0; j < sectionTableForEachFile[inputFiles.at(i)].size(); j++) {
-      bool found = false;
-      for (auto it = mergedSections.begin(); it != mergedSections.end(); it++) {
-        if (it->offset > sectionTableForEachFile[inputFiles.at(i)].at(j).offset) {
-          mergedSections.insert(it, sectionTableForEachFile[inputFiles.at(i)].at(j));
-          found = true;
-          break;
-        }
-      }
-      if (!found) mergedSections.push_back(sectionTableForEachFile[inputFiles.at(i)].at(j));
-    }
+  sectionsByAddress.clear();
+  for (int i = 0; i < mergedSections.size(); i++) {
+    sectionsByAddress.push_back(i);
   }
+  // sections at the same address keep their order of first appearance
+  std::stable_sort(sectionsByAddress.begin(), sectionsByAddress.end(), [&](int a, int b) {
+    return mergedSections.at(a).offset < mergedSections.at(b).offset;
+  });
 }
 
-void Linker::createBinaryFile() {
-  std::string filename = outfileStr;
-  filename.pop_back();
-  filename.pop_back();
-  filename.pop_back();
-  filename.pop_back();
-
-  filename += ".lnk";
-  
-  std::ofstream outputFile(filename, std::ios::out | std::ios::binary);
-
-  int numOfEntries = 0;
-  numOfEntries = mergedSections.size();
-  outputFile.write((char*)&numOfEntries, sizeof(int));
+// The .lnk file (unless it is already there) and the text output, both from the image.
+void Linker::createImageFiles(bool binary) {
+  std::vector<ImageSection> sections;
+  for (int i = 0; i < sectionsByAddress.size(); i++) {
+    const MergedSection& merged = mergedSections.at(sectionsByAddress.at(i));
+    ImageSection section = {(unsigned int)merged.offset, image.data() + merged.imageOffset, (size_t)merged.length};
+    sections.push_back(section);
+  }
 
-  for (int i = 0; i < numOfEntries; i++) {
-    SectionTableEntry currSection = mergedSections.at(i);
-    std::string currString = stringstreamPerMergedSection[currSection.name].str();
-    int address = currSection.offset;
-    int len = currString.length();
-    outputFile.write((char*)&address, sizeof(int));
-    outputFile.write((char*)&len, sizeof(int));
-    outputFile.write((char*)currString.c_str(), len);
+  if (!writeImageFiles(sections, binary ? outputFileName(".lnk") : "", outfileStr, threads)) {
+    std::cout << "could not write the output files.\n";
   }
-  outputFile.close();
 }
 
+// One line per defined symbol, "address kind name" sorted by address, where kind is
+// g (global), s (section) or l (local). Read by the emulator's profiler.
+void Linker::createSymbolFile() {
+  std::string filename = outputFileName(".sym");
 
-void Linker::createTextFile() {
-  std::ofstream outputFile(outfileStr, std::ios::out);
-  bool firstLine = true;
+  std::vector<std::pair<unsigned int, std::string>> lines;
+  for (int i = 0; i < linkState.symbols.size(); i++) {
+    const CachedSymbol& symbol = linkState.symbols.at(i);
+    lines.push_back(std::make_pair((unsigned int)symbol.value, std::string(1, symbol.kind) + " " + symbol.name));
+  }
+  std::sort(lines.begin(), lines.end());
+  lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
 
+  std::ofstream outputFile(filename, std::ios::out);
+  for (int i = 0; i < lines.size(); i++) {
+    outputFile << std::setfill('0') << std::setw(8) << std::hex << lines.at(i).first << " " << lines.at(i).second << "\n";
+  }
+  outputFile.close();
+}
 
-  for (int i = 0; i < mergedSections.size(); i++) {
-    std::string str = stringstreamPerMergedSection[mergedSections.at(i).name].str();
-    int address = mergedSections.at(i).offset;
-    int counter = 0;
-
-    for (int k = 0; k < str.length(); k++) {
-      if (counter % 8 == 0) {
-        if (firstLine == false) outputFile << "\n";
-        firstLine = false;
-        counter = 0;
-        outputFile << std::setfill('0') << std::setw(8) << std::hex << address;
-        outputFile << ": ";
-      }
-      unsigned char c = str.c_str()[k];
-      outputFile << std::setfill('0') << std::setw(2) << std::hex << (unsigned int)c;
-      outputFile << " ";
+// Sections in address order, each followed by what every input contributed to it, then all symbols
+// in address order, one per line: "section address size name", "part address size file" and
+// "symbol address kind name file". Read by the emulator to show where addresses point.
+void Linker::createMapFile() {
+  std::vector<std::vector<std::pair<int, int>>> partsOfSection(linkState.sections.size()); // (input, part)
+  for (int i = 0; i < linkState.inputs.size(); i++) {
+    for (int j = 0; j < linkState.inputs.at(i).parts.size(); j++) {
+      int sectionIndex = linkState.inputs.at(i).parts.at(j).sectionIndex;
+      if (sectionIndex != -1) partsOfSection.at(sectionIndex).push_back(std::make_pair(i, j));
+    }
+  }
 
-      counter++;
-      address++;
+  // a section symbol before the global at its address, as in the .sym file
+  std::vector<const CachedSymbol*> symbols;
+  for (int i = 0; i < linkState.symbols.size(); i++) symbols.push_back(&linkState.symbols.at(i));
+  std::stable_sort(symbols.begin(), symbols.end(), [](const CachedSymbol* a, const CachedSymbol* b) {
+    if (a->value != b->value) return (unsigned int)a->value < (unsigned int)b->value;
+    return a->kind == 's' && b->kind != 's';
+  });
+
+  std::ofstream outputFile(outputFileName(".map"), std::ios::out);
+  outputFile << std::setfill('0') << std::hex;
+  for (int k = 0; k < linkState.sections.size(); k++) {
+    const CachedSection& section = linkState.sections.at(k);
+    outputFile << "section " << std::setw(8) << section.address << " " << std::setw(8) << section.length << " " << section.name << "\n";
+    for (int p = 0; p < partsOfSection.at(k).size(); p++) {
+      const CachedInput& input = linkState.inputs.at(partsOfSection.at(k).at(p).first);
+      const CachedPart& part = input.parts.at(partsOfSection.at(k).at(p).second);
+      outputFile << "part " << std::setw(8) << section.address + part.offset << " " << std::setw(8) << part.length << " " << input.file << "\n";
     }
   }
+  for (int i = 0; i < symbols.size(); i++) {
+    outputFile << "symbol " << std::setw(8) << symbols.at(i)->value << " " << symbols.at(i)->kind << " " << symbols.at(i)->name
+               << " " << linkState.inputs.at(symbols.at(i)->fileId).file << "\n";
+  }
   outputFile.close();
 }
 
@@ -486,39 +560,315 @@ void Linker::setIsHex(bool boolean) {
   isHex = boolean;
 }
 
+void Linker::setThreads(unsigned int count) {
+  threads = count;
+}
+
+void Linker::setIncremental(bool boolean) {
+  incremental = boolean;
+}
+
+void Linker::setGcSections(bool boolean) {
+  gcSections = boolean;
+}
+
+void Linker::setEntrySymbol(std::string str) {
+  entrySymbol = str;
+}
+
 void Linker::printOutputFileName() {
   //std::cout << "output (" << outfileStr << ")\n\n";
 }
 
 bool Linker::checkAndPrintMultipleDefinitions() {
-  bool multipleDefinitionsExist = false;
-  for (auto it = symbolTimesDefined.begin(); it != symbolTimesDefined.end(); it++) {
-    if (it->second >= 2) {
-      std::cout << "Multiple definitions of symbol '" << it->first << "' exist.\n";
-      multipleDefinitionsExist = true;
-    }
+  // reported once per symbol, in name order
+  std::sort(multiplyDefinedSymbols.begin(), multiplyDefinedSymbols.end());
+  multiplyDefinedSymbols.erase(std::unique(multiplyDefinedSymbols.begin(), multiplyDefinedSymbols.end()), multiplyDefinedSymbols.end());
+  for (int i = 0; i < multiplyDefinedSymbols.size(); i++) {
+    std::cout << "Multiple definitions of symbol '" << multiplyDefinedSymbols.at(i) << "' exist.\n";
   }
-  return multipleDefinitionsExist;
+  return !multiplyDefinedSymbols.empty();
 }
 
 bool Linker::link() {
+  // which parts survive depends on all of the inputs, so there is nothing to patch
+  if (gcSections) incremental = false;
+  if (incremental && isHex && relinkIncrementally()) return true;
+
   std::cout << "linking... \n";
-  analizeInputFiles();
+  if (!analizeInputFiles()) return false;
 
   std::cout << "checking for multiple definitions of global symbols...\n";
   bool multipleDefinitionsExist = checkAndPrintMultipleDefinitions();
 
   if (multipleDefinitionsExist) return false;
+  if (gcSections && !collectGarbageSections()) return false;
 
   std::cout << "merging... \n";
   mergeSections();
-
-  putAndSortSectionsIntoOneVector();
+  recordLinkState();
 
   if (isHex == true) {
-    createTextFile();
-    createBinaryFile();
+    createImageFiles(true);
+    createSymbolFile();
+    createMapFile();
+
+    // a cache left by an earlier incremental link no longer describes the output
+    if (incremental) {
+      linkState.write(outputFileName(".cache"));
+    } else {
+      remove(outputFileName(".cache").c_str());
+    }
+  }
+
+  return true;
+}
+
+std::string Linker::outputFileName(const std::string& extension) {
+  // "program.hex" -> "program" + extension
+  return outfileStr.substr(0, outfileStr.size() >= 4 ? outfileStr.size() - 4 : 0) + extension;
+}
+
+std::string Linker::linkOptions() {
+  std::stringstream options;
+  for (int i = 0; i < sectionsWithPlaceOption.size(); i++) {
+    options << sectionsWithPlaceOption.at(i).first << "@" << std::hex << sectionsWithPlaceOption.at(i).second << ";";
+  }
+  return options.str();
+}
+
+// Everything the symbol and map files and the next incremental link need, taken from the tables of this link.
+void Linker::recordLinkState() {
+  // positions of the globals are the site symbols, discarded ones only happen without sites
+  for (int i = 0; i < globalSymbolTable.size(); i++) {
+    const SymbolTableEntry& symbol = globalSymbolTable.at(i);
+    if (isDiscarded(symbol)) continue;
+    CachedSymbol cached = {std::string(symbol.name), symbol.fileId, symbol.value, 'g'};
+    linkState.symbols.push_back(cached);
+  }
+  for (int i = 0; i < inputFiles.size(); i++) {
+    for (int j = 0; j < symbolTablesForEachFile[i].size(); j++) {
+      const SymbolTableEntry& symbol = symbolTablesForEachFile[i].at(j);
+      if (isDiscarded(symbol)) continue;
+      int sectionIndex = symbol.sectionIndex;
+      bool isSection = sectionIndex != -1 && sectionTableForEachFile[i].at(sectionIndex).nameId == symbol.nameId;
+      CachedSymbol cached = {std::string(symbol.name), i, symbol.value, isSection ? 's' : 'l'};
+      linkState.symbols.push_back(cached);
+    }
+  }
+
+  std::vector<int> addressOrder(mergedSections.size()); // merged section -> position in sectionsByAddress
+  for (int i = 0; i < sectionsByAddress.size(); i++) {
+    const MergedSection& merged = mergedSections.at(sectionsByAddress.at(i));
+    addressOrder.at(sectionsByAddress.at(i)) = i;
+    CachedSection cached = {merged.name, merged.offset, merged.length};
+    linkState.sections.push_back(cached);
+  }
+
+  // parts removed by -gc-sections have no section
+  for (int i = 0; i < inputFiles.size(); i++) {
+    CachedInput input;
+    input.file = inputFiles.at(i);
+    input.hash = inputHashes.at(i);
+    for (int j = 0; j < sectionTableForEachFile[i].size(); j++) {
+      const SectionTableEntry& section = sectionTableForEachFile[i].at(j);
+      int sectionIndex = section.mergedId == -1 ? -1 : addressOrder.at(section.mergedId);
+      CachedPart part = {std::string(section.name), section.length, sectionIndex, section.offset};
+      input.parts.push_back(part);
+    }
+    linkState.inputs.push_back(input);
+  }
+  if (!incremental) return;
+
+  linkState.options = linkOptions();
+  for (int i = 0; i < linkState.sites.size(); i++) {
+    linkState.sites.at(i).sectionIndex = addressOrder.at(linkState.sites.at(i).sectionIndex);
+  }
+}
+
+// Value of a symbol of a changed input once its section is placed where the cached part is.
+static int relinkedValue(const ObjectFile& object, const CachedInput& input, const LinkCache& cache, const ObjectSymbol& symbol) {
+  int k = object.findSection(symbol.section);
+  if (k == -1) return symbol.value;
+  const CachedPart& part = input.parts.at(k);
+  return symbol.value + cache.sections.at(part.sectionIndex).address + part.offset;
+}
+
+// Patches the output of the previous link in place. Only possible when the inputs and -place
+// options are the same as last time, and every changed input still has the same sections with
+// the same lengths and defines the same globals. Otherwise returns false before writing anything.
+bool Linker::relinkIncrementally() {
+  LinkCache cache;
+  if (!cache.read(outputFileName(".cache"))) return false;
+  if (cache.options != linkOptions() || cache.inputs.size() != inputFiles.size()) return false;
+  for (int i = 0; i < inputFiles.size(); i++) {
+    if (cache.inputs.at(i).file != inputFiles.at(i)) return false;
+  }
+
+  std::string binaryFile = outputFileName(".lnk");
+  struct stat info;
+  if (stat(binaryFile.c_str(), &info) < 0 || info.st_size != cache.imageSize()) return false;
+
+  // find the changed inputs
+  mappedFiles.resize(inputFiles.size());
+  inputHashes.resize(inputFiles.size());
+  std::vector<char> opened(inputFiles.size());
+  ThreadPool pool(threads);
+  for (int i = 0; i < inputFiles.size(); i++) {
+    pool.submit([this, i, &opened]() {
+      mappedFiles.at(i).reset(new MappedFile());
+      opened.at(i) = mappedFiles.at(i)->open(inputFiles.at(i));
+      if (opened.at(i)) inputHashes.at(i) = hashBytes(mappedFiles.at(i)->data(), mappedFiles.at(i)->size());
+    });
   }
+  pool.run();
 
+  std::vector<int> changed;
+  for (int i = 0; i < inputFiles.size(); i++) {
+    if (!opened.at(i)) return false;
+    if (inputHashes.at(i) != cache.inputs.at(i).hash) changed.push_back(i);
+  }
+  if (changed.empty()) {
+    std::cout << "output is up to date.\n";
+    return true;
+  }
+
+  // the changed inputs must fit where their old versions were
+  int globalCount = 0;
+  std::unordered_map<std::string, int> globals; // name -> index in cache.symbols
+  while (globalCount < cache.symbols.size() && cache.symbols.at(globalCount).kind == 'g') {
+    globals[cache.symbols.at(globalCount).name] = globalCount;
+    globalCount++;
+  }
+  std::vector<int> values(globalCount);
+  for (int g = 0; g < globalCount; g++) values.at(g) = cache.symbols.at(g).value;
+
+  std::vector<ObjectFile> objects(inputFiles.size());
+  for (int c = 0; c < changed.size(); c++) {
+    int i = changed.at(c);
+    ObjectFile& object = objects.at(i);
+    const CachedInput& input = cache.inputs.at(i);
+    if (!object.read(mappedFiles.at(i)->data(), mappedFiles.at(i)->size())) return false;
+
+    if (object.sections.size() != input.parts.size()) return false;
+    for (int k = 0; k < object.sections.size(); k++) {
+      if (object.sections.at(k).name != input.parts.at(k).section || object.sections.at(k).length != input.parts.at(k).length) return false;
+    }
+
+    // same globals in the same order, so the global table keeps its order too
+    int g = 0;
+    for (int j = 0; j < object.symbols.size(); j++) {
+      const ObjectSymbol& symbol = object.symbols.at(j);
+      if (!symbol.isDefined || (!symbol.isGlobal && !symbol.isExtern)) continue;
+      while (g < globalCount && cache.symbols.at(g).fileId != i) g++;
+      if (g == globalCount || cache.symbols.at(g).name != symbol.name) return false;
+      values.at(g) = relinkedValue(object, input, cache, symbol);
+      g++;
+    }
+    while (g < globalCount && cache.symbols.at(g).fileId != i) g++;
+    if (g != globalCount) return false;
+  }
+
+  std::cout << "relinking " << changed.size() << " of " << inputFiles.size() << " input files...\n";
+
+  int fd = open(binaryFile.c_str(), O_RDWR);
+  if (fd < 0) return false;
+  bool written = true;
+  std::vector<long long> sectionOffsets(cache.sections.size());
+  for (int k = 0; k < cache.sections.size(); k++) sectionOffsets.at(k) = cache.imageOffset(k);
+
+  std::vector<char> isChanged(inputFiles.size(), false);
+  std::vector<CachedSymbol> symbols(cache.symbols.begin(), cache.symbols.begin() + globalCount);
+  std::vector<CachedSite> sites;
+  for (int g = 0; g < globalCount; g++) symbols.at(g).value = values.at(g);
+
+  for (int c = 0; c < changed.size(); c++) {
+    int i = changed.at(c);
+    const ObjectFile& object = objects.at(i);
+    const CachedInput& input = cache.inputs.at(i);
+    isChanged.at(i) = true;
+
+    for (int k = 0; k < object.sections.size(); k++) {
+      const CachedPart& part = input.parts.at(k);
+      size_t length = object.sections.at(k).data.length() < (size_t)part.length ? object.sections.at(k).data.length() : part.length;
+      written &= pwrite(fd, object.sections.at(k).data.data(), length, sectionOffsets.at(part.sectionIndex) + part.offset) == length;
+    }
+
+    std::unordered_map<std::string_view, int> locals; // the first definition of a name wins, as in a full link
+    for (int j = 0; j < object.symbols.size(); j++) {
+      const ObjectSymbol& symbol = object.symbols.at(j);
+      if (!symbol.isDefined || symbol.isGlobal || symbol.isExtern) continue;
+      int value = relinkedValue(object, input, cache, symbol);
+      locals.insert(std::make_pair(symbol.name, value));
+      int k = object.findSection(symbol.section);
+      bool isSection = k != -1 && object.sections.at(k).name == symbol.name;
+      CachedSymbol cached = {std::string(symbol.name), i, value, isSection ? 's' : 'l'};
+      symbols.push_back(cached);
+    }
+
+    for (int j = 0; j < object.relocations.size(); j++) {
+      const ObjectRelocation& reloc = object.relocations.at(j);
+      int k = object.findSection(reloc.section);
+      if (k == -1 || reloc.offset < 0 || reloc.offset > input.parts.at(k).length - (int)sizeof(int)) continue;
+      const CachedPart& part = input.parts.at(k);
+
+      int value;
+      auto local = locals.find(reloc.symbol);
+      if (local != locals.end()) {
+        value = local->second;
+      } else {
+        auto global = globals.find(std::string(reloc.symbol));
+        if (global == globals.end()) continue;
+        value = values.at(global->second);
+        CachedSite site = {i, part.sectionIndex, part.offset + reloc.offset, global->second};
+        sites.push_back(site);
+      }
+      written &= pwrite(fd, &value, sizeof(int), sectionOffsets.at(part.sectionIndex) + part.offset + reloc.offset) == sizeof(int);
+    }
+    cache.inputs.at(i).hash = inputHashes.at(i);
+  }
+
+  // unchanged inputs only need the relocations to globals that moved
+  for (int j = 0; j < cache.sites.size(); j++) {
+    const CachedSite& site = cache.sites.at(j);
+    if (isChanged.at(site.fileId)) continue;
+    sites.push_back(site);
+    int value = values.at(site.symbol);
+    if (value == cache.symbols.at(site.symbol).value) continue;
+    written &= pwrite(fd, &value, sizeof(int), sectionOffsets.at(site.sectionIndex) + site.offset) == sizeof(int);
+  }
+  for (int j = globalCount; j < cache.symbols.size(); j++) {
+    if (!isChanged.at(cache.symbols.at(j).fileId)) symbols.push_back(cache.symbols.at(j));
+  }
+  written &= close(fd) == 0;
+  if (!written) {
+    std::cout << "could not patch '" << binaryFile << "'.\n";
+    remove(outputFileName(".cache").c_str());
+    return false;
+  }
+
+  cache.symbols = symbols;
+  cache.sites = sites;
+  linkState = cache;
+  linkState.write(outputFileName(".cache"));
+
+  // the text output and symbol file are written again from the patched image
+  MappedFile binary;
+  if (!binary.open(binaryFile)) return false;
+  image.assign(binary.data(), binary.data() + binary.size());
+  mergedSections.clear();
+  sectionsByAddress.clear();
+  for (int k = 0; k < cache.sections.size(); k++) {
+    MergedSection merged;
+    merged.name = cache.sections.at(k).name;
+    merged.offset = cache.sections.at(k).address;
+    merged.length = cache.sections.at(k).length;
+    merged.imageOffset = sectionOffsets.at(k);
+    mergedSections.push_back(merged);
+    sectionsByAddress.push_back(k);
+  }
+  createImageFiles(false);
+  createSymbolFile();
+  createMapFile();
   return true;
 }
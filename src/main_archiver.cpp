@@ -0,0 +1,59 @@
+#include <iostream>
+#include "../inc/archive.hpp"
+#include "../inc/object_file.hpp"
+#include <vector>
+
+// archiver -o library.a file1.o file2.o ...   creates an archive
+// archiver -t library.a                       lists its members and symbol index
+int main(int argc, const char* argv[]) {
+  std::vector<std::string> arguments;
+  for (int i = 1; i < argc; i++) {
+    arguments.push_back(std::string(argv[i]));
+  }
+
+  std::string outputFile = "";
+  std::string listFile = "";
+  std::vector<std::string> inputFiles;
+  for (int i = 0; i < arguments.size(); i++) {
+    std::string str = arguments.at(i);
+    if (str == "-o" && i + 1 < arguments.size()) {
+      outputFile = arguments.at(++i);
+    } else if (str == "-t" && i + 1 < arguments.size()) {
+      listFile = arguments.at(++i);
+    } else {
+      inputFiles.push_back(str);
+    }
+  }
+
+  if (listFile != "") {
+    if (outputFile != "" || !inputFiles.empty()) {
+      std::cout << "-t takes only the archive.\n";
+      return -1;
+    }
+    MappedFile mapped;
+    Archive archive;
+    if (!mapped.open(listFile) || !archive.read(mapped.data(), mapped.size())) {
+      std::cout << "archive '" << listFile << "' does not exist or is not an archive.\n";
+      return -1;
+    }
+    for (int i = 0; i < archive.members.size(); i++) {
+      std::cout << archive.members.at(i).name << " (" << archive.members.at(i).contents.size() << " bytes)\n";
+    }
+    for (int k = 0; k < archive.symbolCount(); k++) {
+      std::cout << archive.symbolName(k) << " in " << archive.members.at(archive.symbolMember(k)).name << "\n";
+    }
+    return 0;
+  }
+
+  if (outputFile == "" || inputFiles.empty()) {
+    std::cout << "there must be an output file (-o) and at least 1 input file.\n";
+    return -1;
+  }
+
+  std::string error;
+  if (!writeArchive(outputFile, inputFiles, error)) {
+    std::cout << "could not create archive: " << error << ".\n";
+    return -1;
+  }
+  return 0;
+}
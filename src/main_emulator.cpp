@@ -1,17 +1,140 @@
 #include <iostream>
 #include "../inc/emulator.hpp"
+#include "../inc/batch.hpp"
 #include <vector>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+
+// A whole decimal argument no larger than max, false for anything else (signs, trailing characters).
+static bool parseNumber(const std::string& str, unsigned long long max, unsigned long long& value) {
+  if (str.empty() || str.at(0) < '0' || str.at(0) > '9') return false;
+  char* end;
+  errno = 0;
+  unsigned long long parsed = strtoull(str.c_str(), &end, 10);
+  if (errno != 0 || *end != '\0' || parsed > max) return false;
+  value = parsed;
+  return true;
+}
+
+static bool parseNumber(const std::string& str, unsigned int& value) {
+  unsigned long long parsed;
+  if (!parseNumber(str, UINT_MAX, parsed)) return false;
+  value = parsed;
+  return true;
+}
 
 int main(int argc, const char* argv[]) {
-  if (argc != 2) {
+  std::vector<std::string> arguments;
+  for (int i = 1; i < argc; i++) {
+    arguments.push_back(std::string(argv[i]));
+  }
+
+  bool stats = false;
+  bool blockStats = false;
+  unsigned long long maxInstructions = 0;
+  unsigned long long maxCycles = 0;
+  unsigned long long maxTime = 0;
+  bool jit = false;
+  bool jitVerify = false;
+  unsigned int jitThreshold = JIT_THRESHOLD;
+  std::string batchFile = "";
+  unsigned int threads = 0;
+  std::string outputFile = "batch_results.json";
+  bool profile = false;
+  std::string symbolFile = "";
+  std::string mapFile = "";
+  std::string traceFile = "";
+  std::string recordFile = "";
+  std::string replayFile = "";
+  std::string gdbAddress = "";
+  std::string restoreFile = "";
+  std::string saveFile = "";
+
+  std::string inputFile = "";
+  bool valid = true;
+  for (int i = 0; i < arguments.size(); i++) {
+    std::string str = arguments.at(i);
+    if (str == "--stats") {
+      stats = true;
+    } else if (str == "--block-stats") {
+      blockStats = true;
+    } else if (str.rfind("--max-instructions=", 0) == 0) {
+      valid = parseNumber(str.substr(str.find('=') + 1), ULLONG_MAX, maxInstructions);
+    } else if (str.rfind("--max-cycles=", 0) == 0) {
+      valid = parseNumber(str.substr(str.find('=') + 1), ULLONG_MAX, maxCycles);
+    } else if (str.rfind("--max-time=", 0) == 0) {
+      valid = parseNumber(str.substr(str.find('=') + 1), ULLONG_MAX, maxTime);
+    } else if (str == "--jit") {
+      jit = true;
+    } else if (str == "--jit-verify") {
+      jitVerify = true;
+    } else if (str.rfind("--jit-threshold=", 0) == 0) {
+      valid = parseNumber(str.substr(str.find('=') + 1), jitThreshold);
+    } else if (str == "--profile") {
+      profile = true;
+    } else if (str.rfind("--symbols=", 0) == 0) {
+      symbolFile = str.substr(str.find('=') + 1);
+    } else if (str.rfind("--map=", 0) == 0) {
+      mapFile = str.substr(str.find('=') + 1);
+    } else if (str.rfind("--trace=", 0) == 0) {
+      traceFile = str.substr(str.find('=') + 1);
+    } else if (str.rfind("--record=", 0) == 0) {
+      recordFile = str.substr(str.find('=') + 1);
+    } else if (str.rfind("--replay=", 0) == 0) {
+      replayFile = str.substr(str.find('=') + 1);
+    } else if (str.rfind("--restore=", 0) == 0) {
+      restoreFile = str.substr(str.find('=') + 1);
+    } else if (str.rfind("--save-snapshot=", 0) == 0) {
+      saveFile = str.substr(str.find('=') + 1);
+    } else if (str == "--batch" && i + 1 < arguments.size()) {
+      batchFile = arguments.at(++i);
+    } else if (str == "--gdb" && i + 1 < arguments.size()) {
+      gdbAddress = arguments.at(++i);
+    } else if (str == "-j" && i + 1 < arguments.size()) {
+      valid = parseNumber(arguments.at(++i), threads);
+    } else if (str == "-o" && i + 1 < arguments.size()) {
+      outputFile = arguments.at(++i);
+    } else if (inputFile == "") {
+      inputFile = str;
+    } else {
+      valid = false;
+    }
+    if (!valid) break;
+  }
+
+  auto configure = [&](Emulator& emulator) {
+    emulator.setStats(stats);
+    emulator.setBlockStats(blockStats);
+    emulator.setMaxInstructions(maxInstructions);
+    emulator.setMaxCycles(maxCycles);
+    emulator.setMaxTime(maxTime);
+    emulator.setJit(jit);
+    emulator.setJitVerify(jitVerify);
+    emulator.setJitThreshold(jitThreshold);
+  };
+
+  if (valid && batchFile != "" && inputFile == "") {
+    Batch batch(batchFile, threads, outputFile);
+    return batch.run(configure);
+  }
+
+  // a restored snapshot takes the place of the input file
+  if (!valid || batchFile != "" || (inputFile == "") == (restoreFile == "")) {
     std::cout << "there must be 1 argument (input file).\n";
     return -1;
   }
-  std::vector<std::string> arguments;
-  arguments.push_back(std::string(argv[1]));
-  std::string str = arguments.at(0);
-  Emulator::getInstance().setInputFile(str);
-  Emulator::getInstance().execute();
-
-  return 0;
-}
\ No newline at end of file
+  Emulator emulator;
+  configure(emulator);
+  emulator.setInputFile(inputFile);
+  emulator.setRestoreFile(restoreFile);
+  emulator.setSaveFile(saveFile);
+  emulator.setProfile(profile);
+  emulator.setSymbolFile(symbolFile);
+  emulator.setMapFile(mapFile);
+  emulator.setTraceFile(traceFile);
+  emulator.setRecordFile(recordFile);
+  emulator.setReplayFile(replayFile);
+  emulator.setGdb(gdbAddress);
+  return emulator.execute();
+}
@@ -6,6 +6,7 @@ using namespace std;
 
 int main(int argc, const char* argv[]) {
   bool nextOneIsOutputFile = false;
+  bool nextOneIsThreadCount = false;
   std::vector<std::string> arguments;
   for (int i = 0; i < argc; i++) {
     arguments.push_back(std::string(argv[i]));
@@ -17,6 +18,13 @@ int main(int argc, const char* argv[]) {
     if (str == "-o") {
       nextOneIsOutputFile = true;
 
+    } else if (str == "-j") {
+      nextOneIsThreadCount = true;
+
+    } else if (nextOneIsThreadCount) {
+      nextOneIsThreadCount = false;
+      Linker::getInstance().setThreads(stoul(str));
+
     } else if (nextOneIsOutputFile) {
       nextOneIsOutputFile = false;
       Linker::getInstance().setOutput(str);
@@ -39,6 +47,12 @@ int main(int argc, const char* argv[]) {
 
     } else if (str == "-hex") {
       Linker::getInstance().setIsHex(true);
+    } else if (str == "-incremental") {
+      Linker::getInstance().setIncremental(true);
+    } else if (str == "-gc-sections" || str == "--gc-sections") {
+      Linker::getInstance().setGcSections(true);
+    } else if (str.rfind("-entry=", 0) == 0) {
+      Linker::getInstance().setEntrySymbol(str.substr(7));
     } else {
       Linker::getInstance().addInputFile(str);
     }
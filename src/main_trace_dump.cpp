@@ -0,0 +1,71 @@
+#include <iostream>
+#include <iomanip>
+#include "../inc/emulator.hpp"
+#include "../inc/tracer.hpp"
+#include <vector>
+
+static const char* csrNames[CS_REGS_NUM] = {"status", "handler", "cause"};
+
+int main(int argc, const char* argv[]) {
+  std::vector<std::string> arguments;
+  for (int i = 1; i < argc; i++) {
+    arguments.push_back(std::string(argv[i]));
+  }
+
+  unsigned long long skip = 0;
+  unsigned long long limit = ~0ULL;
+  std::string inputFile = "";
+  bool valid = true;
+  for (int i = 0; i < arguments.size(); i++) {
+    std::string str = arguments.at(i);
+    if (str.rfind("--skip=", 0) == 0) {
+      skip = std::stoull(str.substr(str.find('=') + 1));
+    } else if (str.rfind("--limit=", 0) == 0) {
+      limit = std::stoull(str.substr(str.find('=') + 1));
+    } else if (inputFile == "") {
+      inputFile = str;
+    } else {
+      valid = false;
+      break;
+    }
+  }
+
+  if (!valid || inputFile == "") {
+    std::cout << "there must be 1 argument (trace file).\n";
+    return -1;
+  }
+
+  TraceReader reader;
+  if (!reader.open(inputFile)) {
+    std::cout << "trace file '" << inputFile << "' does not exist or is not a trace.\n";
+    return -1;
+  }
+
+  // every record has to be decoded to keep the deltas right, skipped ones just aren't printed
+  TraceRecord record;
+  unsigned long long index = 0;
+  unsigned long long printed = 0;
+  while (printed < limit && reader.next(record)) {
+    if (index++ < skip) continue;
+    printed++;
+
+    std::cout << std::dec << std::setw(12) << std::setfill(' ') << index - 1 << "  "
+              << std::hex << std::setfill('0') << std::setw(8) << record.pc << "  "
+              << std::setw(8) << record.word << "  "
+              << std::left << std::setw(10) << std::setfill(' ') << opcodeName(record.word >> 24) << std::right;
+
+    if (record.flags & TRACE_REGISTER) {
+      std::cout << "  ";
+      if (record.reg < GP_REGS_NUM) std::cout << "r" << std::dec << (int)record.reg;
+      else std::cout << csrNames[record.reg - GP_REGS_NUM];
+      std::cout << "=0x" << std::hex << std::setfill('0') << std::setw(8) << (unsigned int)record.value;
+    }
+    if (record.flags & (TRACE_LOAD | TRACE_STORE)) {
+      std::cout << ((record.flags & TRACE_STORE) ? "  st [0x" : "  ld [0x") << std::hex << std::setfill('0')
+                << std::setw(8) << record.address << "]=0x" << std::setw(8) << (unsigned int)record.data;
+    }
+    std::cout << "\n";
+  }
+
+  return 0;
+}
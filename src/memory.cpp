@@ -0,0 +1,125 @@
+#include "../inc/memory.hpp"
+
+Memory::Memory() {
+  for (int i = 0; i < GUEST_DIRECTORY_SIZE; i++) {
+    directory[i] = nullptr;
+  }
+}
+
+Memory::~Memory() {
+  clear();
+}
+
+void Memory::clear() {
+  for (int i = 0; i < GUEST_DIRECTORY_SIZE; i++) {
+    if (directory[i] == nullptr) continue;
+    for (int j = 0; j < GUEST_TABLE_SIZE; j++) {
+      Page* page = directory[i][j];
+      if (page == nullptr) continue;
+      if (!page->mapped) delete[] page->data;
+      delete page;
+    }
+    delete[] directory[i];
+    directory[i] = nullptr;
+  }
+}
+
+Page*& Memory::pageEntry(unsigned int address) {
+  Page**& table = directory[address >> (GUEST_PAGE_BITS + GUEST_TABLE_BITS)];
+  if (table == nullptr) {
+    table = new Page*[GUEST_TABLE_SIZE]();
+  }
+
+  return table[(address >> GUEST_PAGE_BITS) & (GUEST_TABLE_SIZE - 1)];
+}
+
+Page* Memory::allocatePage(unsigned int address) {
+  Page*& page = pageEntry(address);
+  page = new Page();
+  page->data = new unsigned char[GUEST_PAGE_SIZE]();
+  return page;
+}
+
+void Memory::load(unsigned int address, unsigned char* source, unsigned int length) {
+  while (length > 0) {
+    unsigned int offset = address & (GUEST_PAGE_SIZE - 1);
+    unsigned int chunk = GUEST_PAGE_SIZE - offset < length ? GUEST_PAGE_SIZE - offset : length;
+
+    if (chunk == GUEST_PAGE_SIZE && findPage(address) == nullptr) {
+      // whole page comes from the image, point at it instead of copying
+      Page*& page = pageEntry(address);
+      page = new Page();
+      page->data = source;
+      page->mapped = true;
+      memset(page->written, 0xff, sizeof(page->written));
+    } else {
+      Page* page = getPage(address);
+      memcpy(page->data + offset, source, chunk);
+      for (unsigned int k = offset; k < offset + chunk; k++) {
+        page->written[k >> 3] |= 1 << (k & 7);
+      }
+    }
+
+    address += chunk;
+    source += chunk;
+    length -= chunk;
+  }
+}
+
+void Memory::mapPage(unsigned int address, unsigned char* data, const unsigned char* written) {
+  Page*& page = pageEntry(address);
+  if (page != nullptr && !page->mapped) delete[] page->data;
+  delete page;
+
+  page = new Page();
+  page->data = data;
+  page->mapped = true;
+  memcpy(page->written, written, sizeof(page->written));
+}
+
+unsigned char Memory::readByte(unsigned int address) {
+  Page* page = findPage(address);
+  if (page == nullptr) return 0;
+  return page->data[address & (GUEST_PAGE_SIZE - 1)];
+}
+
+bool Memory::writeByte(unsigned int address, unsigned char value) {
+  Page* page = getPage(address);
+  unsigned int offset = address & (GUEST_PAGE_SIZE - 1);
+  page->data[offset] = value;
+  page->written[offset >> 3] |= 1 << (offset & 7);
+  if (!page->hasCode || (page->code[offset >> 3] & (1 << (offset & 7))) == 0) return false;
+  page->codeWritten = true;
+  return true;
+}
+
+void Memory::markCode(unsigned int address) {
+  for (int i = 0; i < 4; i++) {
+    Page* page = getPage(address + i);
+    unsigned int offset = (address + i) & (GUEST_PAGE_SIZE - 1);
+    page->code[offset >> 3] |= 1 << (offset & 7);
+    page->hasCode = true;
+  }
+}
+
+bool Memory::isCodeWritten(unsigned int address) {
+  Page* page = findPage(address);
+  return page != nullptr && page->codeWritten;
+}
+
+// Word crosses a page boundary (or wraps around the address space), go byte by byte.
+unsigned int Memory::readWordSlow(unsigned int address) {
+  unsigned int value = 0;
+  for (int i = 0; i < 4; i++) {
+    value |= (unsigned int)readByte(address + i) << (8 * i);
+  }
+  return value;
+}
+
+bool Memory::writeWordSlow(unsigned int address, unsigned int value) {
+  bool hitCode = false;
+  for (int i = 0; i < 4; i++) {
+    if (writeByte(address + i, (value >> (8 * i)) & 0b11111111)) hitCode = true;
+  }
+  return hitCode;
+}
@@ -0,0 +1,171 @@
+#include "../inc/object_file.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MappedFile::MappedFile() {
+  mapping = nullptr;
+  length = 0;
+}
+
+MappedFile::~MappedFile() {
+  if (mapping != nullptr) munmap(mapping, length);
+}
+
+// An empty file is valid and has no mapping.
+bool MappedFile::open(const std::string& file) {
+  int fd = ::open(file.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat info;
+  if (fstat(fd, &info) < 0) {
+    close(fd);
+    return false;
+  }
+
+  if (info.st_size > 0) {
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      return false;
+    }
+    mapping = (char*)data;
+    length = info.st_size;
+  }
+  close(fd);
+  return true;
+}
+
+bool ByteReader::readInt(int& value) {
+  if (failed || size - position < sizeof(int)) {
+    failed = true;
+    return false;
+  }
+  memcpy(&value, data + position, sizeof(int));
+  position += sizeof(int);
+  return true;
+}
+
+bool ByteReader::readBool(bool& value) {
+  if (failed || size - position < 1) {
+    failed = true;
+    return false;
+  }
+  value = data[position] != 0;
+  position++;
+  return true;
+}
+
+bool ByteReader::readBytes(size_t count, std::string_view& bytes) {
+  if (failed || size - position < count) {
+    failed = true;
+    return false;
+  }
+  bytes = std::string_view(data + position, count);
+  position += count;
+  return true;
+}
+
+bool ByteReader::readString(std::string_view& str) {
+  int len;
+  if (!readInt(len)) return false;
+  if (len < 0) {
+    failed = true;
+    return false;
+  }
+  return readBytes(len, str);
+}
+
+bool ObjectFile::read(const char* data, size_t size) {
+  symbols.clear();
+  sections.clear();
+  relocations.clear();
+  error = "";
+
+  ByteReader reader(data, size);
+  int numOfEntries = 0;
+
+  reader.readInt(numOfEntries);
+  for (int j = 0; j < numOfEntries && reader.ok(); j++) {
+    ObjectSymbol entry;
+    reader.readString(entry.name);
+    reader.readBool(entry.isDefined);
+    reader.readBool(entry.isGlobal);
+    reader.readBool(entry.isExtern);
+    reader.readInt(entry.value);
+    reader.readString(entry.section);
+    symbols.push_back(entry);
+  }
+
+  reader.readInt(numOfEntries);
+  for (int j = 0; j < numOfEntries && reader.ok(); j++) {
+    ObjectSection entry;
+    reader.readString(entry.name);
+    reader.readInt(entry.id);
+    reader.readInt(entry.length);
+    sections.push_back(entry);
+  }
+
+  reader.readInt(numOfEntries);
+  for (int j = 0; j < numOfEntries && reader.ok(); j++) {
+    ObjectRelocation entry;
+    reader.readString(entry.section);
+    reader.readInt(entry.offset);
+    reader.readInt(entry.type);
+    reader.readString(entry.symbol);
+    reader.readInt(entry.addend);
+    relocations.push_back(entry);
+  }
+
+  reader.readInt(numOfEntries);
+  for (int j = 0; j < numOfEntries && reader.ok(); j++) {
+    std::string_view name;
+    std::string_view contents;
+    if (!reader.readString(name) || !reader.readString(contents)) break;
+
+    int k = findSection(name);
+    if (k == -1 || !sections.at(k).data.empty()) {
+      error = "unexpected contents of section '" + std::string(name) + "'";
+      return false;
+    }
+    sections.at(k).data = contents;
+  }
+
+  if (!reader.ok()) {
+    error = "file is truncated";
+    return false;
+  }
+  if (reader.getPosition() != size) {
+    error = "unexpected data at the end of the file";
+    return false;
+  }
+  return true;
+}
+
+// Files have a handful of sections, a scan is cheaper than building an index.
+int ObjectFile::findSection(std::string_view name) const {
+  for (int i = 0; i < sections.size(); i++) {
+    if (sections.at(i).name == name) return i;
+  }
+  return -1;
+}
+
+bool readImageSegments(const char* data, size_t size, std::vector<ImageSegment>& segments) {
+  ByteReader reader(data, size);
+  int numOfEntries = 0;
+  reader.readInt(numOfEntries);
+  for (int i = 0; i < numOfEntries && reader.ok(); i++) {
+    int address;
+    std::string_view contents;
+    if (!reader.readInt(address) || !reader.readString(contents)) break;
+
+    ImageSegment segment;
+    segment.address = address;
+    segment.offset = contents.data() - data;
+    segment.length = contents.size();
+    segments.push_back(segment);
+  }
+  return reader.ok() && reader.getPosition() == size;
+}
@@ -0,0 +1,1965 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "misc/parser.y"
+
+    #include <iostream>
+    #include <string>
+    #include <vector>
+    #include "../inc/assembler.hpp"
+    int yylex(void);
+    int yyerror(const char*);
+    extern int currentLine;
+
+    // u parser.hpp:
+    // - #include <iostream>
+    // - #include "../inc/helpers.hpp"
+
+#line 85 "src/parser.cpp"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "parser.hpp"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_TOKEN_GLOBAL = 3,               /* TOKEN_GLOBAL  */
+  YYSYMBOL_TOKEN_EXTERN = 4,               /* TOKEN_EXTERN  */
+  YYSYMBOL_TOKEN_SECTION = 5,              /* TOKEN_SECTION  */
+  YYSYMBOL_TOKEN_WORD = 6,                 /* TOKEN_WORD  */
+  YYSYMBOL_TOKEN_SKIP = 7,                 /* TOKEN_SKIP  */
+  YYSYMBOL_TOKEN_ASCII = 8,                /* TOKEN_ASCII  */
+  YYSYMBOL_TOKEN_EQU = 9,                  /* TOKEN_EQU  */
+  YYSYMBOL_TOKEN_END = 10,                 /* TOKEN_END  */
+  YYSYMBOL_TOKEN_HALT = 11,                /* TOKEN_HALT  */
+  YYSYMBOL_TOKEN_INT = 12,                 /* TOKEN_INT  */
+  YYSYMBOL_TOKEN_CALL = 13,                /* TOKEN_CALL  */
+  YYSYMBOL_TOKEN_RET = 14,                 /* TOKEN_RET  */
+  YYSYMBOL_TOKEN_IRET = 15,                /* TOKEN_IRET  */
+  YYSYMBOL_TOKEN_JMP = 16,                 /* TOKEN_JMP  */
+  YYSYMBOL_TOKEN_BEQ = 17,                 /* TOKEN_BEQ  */
+  YYSYMBOL_TOKEN_BNE = 18,                 /* TOKEN_BNE  */
+  YYSYMBOL_TOKEN_BGT = 19,                 /* TOKEN_BGT  */
+  YYSYMBOL_TOKEN_PUSH = 20,                /* TOKEN_PUSH  */
+  YYSYMBOL_TOKEN_POP = 21,                 /* TOKEN_POP  */
+  YYSYMBOL_TOKEN_XCHG = 22,                /* TOKEN_XCHG  */
+  YYSYMBOL_TOKEN_ADD = 23,                 /* TOKEN_ADD  */
+  YYSYMBOL_TOKEN_SUB = 24,                 /* TOKEN_SUB  */
+  YYSYMBOL_TOKEN_MUL = 25,                 /* TOKEN_MUL  */
+  YYSYMBOL_TOKEN_DIV = 26,                 /* TOKEN_DIV  */
+  YYSYMBOL_TOKEN_NOT = 27,                 /* TOKEN_NOT  */
+  YYSYMBOL_TOKEN_AND = 28,                 /* TOKEN_AND  */
+  YYSYMBOL_TOKEN_OR = 29,                  /* TOKEN_OR  */
+  YYSYMBOL_TOKEN_XOR = 30,                 /* TOKEN_XOR  */
+  YYSYMBOL_TOKEN_SHL = 31,                 /* TOKEN_SHL  */
+  YYSYMBOL_TOKEN_SHR = 32,                 /* TOKEN_SHR  */
+  YYSYMBOL_TOKEN_LD = 33,                  /* TOKEN_LD  */
+  YYSYMBOL_TOKEN_ST = 34,                  /* TOKEN_ST  */
+  YYSYMBOL_TOKEN_CSRRD = 35,               /* TOKEN_CSRRD  */
+  YYSYMBOL_TOKEN_CSRWR = 36,               /* TOKEN_CSRWR  */
+  YYSYMBOL_TOKEN_COMMENT = 37,             /* TOKEN_COMMENT  */
+  YYSYMBOL_TOKEN_LITERAL = 38,             /* TOKEN_LITERAL  */
+  YYSYMBOL_TOKEN_SYMBOL = 39,              /* TOKEN_SYMBOL  */
+  YYSYMBOL_TOKEN_LABEL = 40,               /* TOKEN_LABEL  */
+  YYSYMBOL_TOKEN_IMM = 41,                 /* TOKEN_IMM  */
+  YYSYMBOL_TOKEN_STRING = 42,              /* TOKEN_STRING  */
+  YYSYMBOL_TOKEN_ENDL = 43,                /* TOKEN_ENDL  */
+  YYSYMBOL_TOKEN_COMMA = 44,               /* TOKEN_COMMA  */
+  YYSYMBOL_TOKEN_GP_REGISTER = 45,         /* TOKEN_GP_REGISTER  */
+  YYSYMBOL_TOKEN_CS_REGISTER = 46,         /* TOKEN_CS_REGISTER  */
+  YYSYMBOL_TOKEN_LEFT_BRACKET = 47,        /* TOKEN_LEFT_BRACKET  */
+  YYSYMBOL_TOKEN_RIGHT_BRACKET = 48,       /* TOKEN_RIGHT_BRACKET  */
+  YYSYMBOL_TOKEN_PLUS = 49,                /* TOKEN_PLUS  */
+  YYSYMBOL_YYACCEPT = 50,                  /* $accept  */
+  YYSYMBOL_inpt = 51,                      /* inpt  */
+  YYSYMBOL_endls = 52,                     /* endls  */
+  YYSYMBOL_line = 53,                      /* line  */
+  YYSYMBOL_label = 54,                     /* label  */
+  YYSYMBOL_content = 55,                   /* content  */
+  YYSYMBOL_directive = 56,                 /* directive  */
+  YYSYMBOL_instruction = 57,               /* instruction  */
+  YYSYMBOL_list_of_literals_and_syms = 58, /* list_of_literals_and_syms  */
+  YYSYMBOL_list_of_symbols = 59            /* list_of_symbols  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  79
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   240
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  50
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  10
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  74
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  174
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   304
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,    79,    79,    79,    79,    82,    85,    90,    90,    90,
+      91,    91,    91,    94,   101,   101,   104,   108,   112,   117,
+     121,   124,   126,   128,   133,   136,   139,   142,   145,   149,
+     152,   155,   160,   163,   168,   171,   176,   179,   184,   187,
+     190,   193,   196,   199,   202,   205,   208,   211,   214,   217,
+     220,   223,   226,   231,   234,   239,   242,   245,   248,   253,
+     256,   261,   264,   269,   272,   275,   278,   283,   286,   294,
+     297,   300,   303,   308,   311
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "TOKEN_GLOBAL",
+  "TOKEN_EXTERN", "TOKEN_SECTION", "TOKEN_WORD", "TOKEN_SKIP",
+  "TOKEN_ASCII", "TOKEN_EQU", "TOKEN_END", "TOKEN_HALT", "TOKEN_INT",
+  "TOKEN_CALL", "TOKEN_RET", "TOKEN_IRET", "TOKEN_JMP", "TOKEN_BEQ",
+  "TOKEN_BNE", "TOKEN_BGT", "TOKEN_PUSH", "TOKEN_POP", "TOKEN_XCHG",
+  "TOKEN_ADD", "TOKEN_SUB", "TOKEN_MUL", "TOKEN_DIV", "TOKEN_NOT",
+  "TOKEN_AND", "TOKEN_OR", "TOKEN_XOR", "TOKEN_SHL", "TOKEN_SHR",
+  "TOKEN_LD", "TOKEN_ST", "TOKEN_CSRRD", "TOKEN_CSRWR", "TOKEN_COMMENT",
+  "TOKEN_LITERAL", "TOKEN_SYMBOL", "TOKEN_LABEL", "TOKEN_IMM",
+  "TOKEN_STRING", "TOKEN_ENDL", "TOKEN_COMMA", "TOKEN_GP_REGISTER",
+  "TOKEN_CS_REGISTER", "TOKEN_LEFT_BRACKET", "TOKEN_RIGHT_BRACKET",
+  "TOKEN_PLUS", "$accept", "inpt", "endls", "line", "label", "content",
+  "directive", "instruction", "list_of_literals_and_syms",
+  "list_of_symbols", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-38)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+      38,    78,    78,    87,   -37,    77,   -38,   -38,   -38,   -38,
+     -38,    85,   -38,   -38,    90,   101,   103,   105,   107,   108,
+     109,   110,   111,   112,   113,   114,   115,   116,   117,   118,
+     119,    75,   120,   121,   123,   -38,   -38,     0,   126,    76,
+     129,   -38,   -38,   -38,   127,   127,   -38,   -38,   -38,   128,
+     -38,   -38,   -38,   -38,   -38,   130,   131,   132,   -38,   -38,
+     133,   134,   135,   136,   137,   138,   139,   140,   141,   142,
+     143,   144,   145,    92,   146,   125,   147,   148,   149,   -38,
+     126,   -38,   151,   158,   -38,   157,    94,   152,   153,   154,
+     155,   156,   159,   160,   161,   162,   163,   164,   165,   166,
+     167,   168,   169,   171,   172,   173,   -10,    80,   174,   175,
+     151,   -38,   -38,   -38,   -38,   -38,   176,   178,   179,   -38,
+     -38,   -38,   -38,   -38,   -38,   -38,   -38,   -38,   -38,   -38,
+     -38,   -38,   180,   181,   -38,   183,    96,   -38,   -38,    98,
+     -38,   184,   -38,   -38,   100,   102,   104,   -38,   -38,   185,
+      99,   186,   -38,   -38,    28,   -38,   -38,   -38,   -38,   -38,
+     -38,   -38,   187,   188,   -38,   106,   190,   191,   189,   192,
+     -38,   -38,   -38,   -38
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       0,     0,     0,     0,     0,     0,    21,    22,    23,    24,
+      25,     0,    29,    26,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,    12,    13,     0,     0,     7,
+      10,    14,    15,    73,    16,    17,    18,    71,    69,    19,
+      20,    27,    28,    30,    31,     0,     0,     0,    38,    39,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     1,
+       4,     5,     2,     8,    11,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       3,     6,     9,    74,    72,    70,     0,     0,     0,    40,
+      41,    42,    43,    44,    45,    46,    47,    48,    49,    50,
+      53,    54,     0,     0,    55,     0,     0,    61,    62,     0,
+      63,     0,    67,    68,     0,     0,     0,    51,    52,     0,
+       0,     0,    59,    60,     0,    32,    33,    34,    35,    36,
+      37,    56,     0,     0,    64,     0,     0,     0,     0,     0,
+      57,    58,    65,    66
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+     -38,   -38,    69,   196,   -38,   199,   -38,   -38,   -38,   200
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int8 yydefgoto[] =
+{
+       0,    37,    82,    38,    39,    40,    41,    42,    49,    44
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_uint8 yytable[] =
+{
+      79,    47,    48,     1,     2,     3,     4,     5,     6,     7,
+       8,     9,    10,    11,    12,    13,    14,    15,    16,    17,
+      18,    19,    20,    21,    22,    23,    24,    25,    26,    27,
+      28,    29,    30,    31,    32,    33,    34,    35,   135,   136,
+      36,     1,     2,     3,     4,     5,     6,     7,     8,     9,
+      10,    11,    12,    13,    14,    15,    16,    17,    18,    19,
+      20,    21,    22,    23,    24,    25,    26,    27,    28,    29,
+      30,    31,    32,    33,    34,    35,   164,   165,    36,     1,
+       2,     3,     4,     5,     6,     7,     8,     9,    10,    11,
+      12,    13,    14,    15,    16,    17,    18,    19,    20,    21,
+      22,    23,    24,    25,    26,    27,    28,    29,    30,    31,
+      32,    33,    34,    71,    72,    50,    73,    43,   137,   138,
+      74,   139,    75,    51,    52,   140,    46,   141,    53,    54,
+     103,   104,   114,   115,   150,   151,   152,   153,   155,   156,
+     157,   158,   159,   160,   168,   169,    55,   162,    56,   110,
+      57,     0,    58,    59,    60,    61,    62,    63,    64,    65,
+      66,    67,    68,    69,    70,    76,    84,    77,    78,    81,
+     106,    85,    86,     0,    87,    88,    89,    90,    91,    92,
+      93,    94,    95,    96,    97,    98,    99,   100,   101,   102,
+     105,   107,   108,   109,   111,   112,   113,   116,   117,   118,
+     119,   120,    45,     0,   121,   122,   123,   124,   125,   126,
+     127,   128,   129,   130,   131,   132,   133,     0,   134,   142,
+     144,   143,   145,   146,     0,   147,   148,   149,     0,   154,
+     161,   166,   167,    80,   163,   170,   171,   172,    83,     0,
+     173
+};
+
+static const yytype_int8 yycheck[] =
+{
+       0,    38,    39,     3,     4,     5,     6,     7,     8,     9,
+      10,    11,    12,    13,    14,    15,    16,    17,    18,    19,
+      20,    21,    22,    23,    24,    25,    26,    27,    28,    29,
+      30,    31,    32,    33,    34,    35,    36,    37,    48,    49,
+      40,     3,     4,     5,     6,     7,     8,     9,    10,    11,
+      12,    13,    14,    15,    16,    17,    18,    19,    20,    21,
+      22,    23,    24,    25,    26,    27,    28,    29,    30,    31,
+      32,    33,    34,    35,    36,    37,    48,    49,    40,     3,
+       4,     5,     6,     7,     8,     9,    10,    11,    12,    13,
+      14,    15,    16,    17,    18,    19,    20,    21,    22,    23,
+      24,    25,    26,    27,    28,    29,    30,    31,    32,    33,
+      34,    35,    36,    38,    39,    38,    41,    39,    38,    39,
+      45,    41,    47,    38,    39,    45,    39,    47,    38,    39,
+      38,    39,    38,    39,    38,    39,    38,    39,    38,    39,
+      38,    39,    38,    39,    38,    39,    45,    48,    45,    80,
+      45,    -1,    45,    45,    45,    45,    45,    45,    45,    45,
+      45,    45,    45,    45,    45,    45,    37,    46,    45,    43,
+      45,    44,    44,    -1,    44,    44,    44,    44,    44,    44,
+      44,    44,    44,    44,    44,    44,    44,    44,    44,    44,
+      44,    44,    44,    44,    43,    37,    39,    45,    45,    45,
+      45,    45,     2,    -1,    45,    45,    45,    45,    45,    45,
+      45,    45,    45,    45,    45,    44,    44,    -1,    45,    45,
+      44,    46,    44,    44,    -1,    45,    45,    44,    -1,    45,
+      45,    44,    44,    37,    48,    45,    45,    48,    39,    -1,
+      48
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     3,     4,     5,     6,     7,     8,     9,    10,    11,
+      12,    13,    14,    15,    16,    17,    18,    19,    20,    21,
+      22,    23,    24,    25,    26,    27,    28,    29,    30,    31,
+      32,    33,    34,    35,    36,    37,    40,    51,    53,    54,
+      55,    56,    57,    39,    59,    59,    39,    38,    39,    58,
+      38,    38,    39,    38,    39,    45,    45,    45,    45,    45,
+      45,    45,    45,    45,    45,    45,    45,    45,    45,    45,
+      45,    38,    39,    41,    45,    47,    45,    46,    45,     0,
+      53,    43,    52,    55,    37,    44,    44,    44,    44,    44,
+      44,    44,    44,    44,    44,    44,    44,    44,    44,    44,
+      44,    44,    44,    38,    39,    44,    45,    44,    44,    44,
+      52,    43,    37,    39,    38,    39,    45,    45,    45,    45,
+      45,    45,    45,    45,    45,    45,    45,    45,    45,    45,
+      45,    45,    44,    44,    45,    48,    49,    38,    39,    41,
+      45,    47,    45,    46,    44,    44,    44,    45,    45,    44,
+      38,    39,    38,    39,    45,    38,    39,    38,    39,    38,
+      39,    45,    48,    48,    48,    49,    44,    44,    38,    39,
+      45,    45,    48,    48
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    50,    51,    51,    51,    52,    52,    53,    53,    53,
+      53,    53,    53,    54,    55,    55,    56,    56,    56,    56,
+      56,    56,    56,    56,    57,    57,    57,    57,    57,    57,
+      57,    57,    57,    57,    57,    57,    57,    57,    57,    57,
+      57,    57,    57,    57,    57,    57,    57,    57,    57,    57,
+      57,    57,    57,    57,    57,    57,    57,    57,    57,    57,
+      57,    57,    57,    57,    57,    57,    57,    57,    57,    58,
+      58,    58,    58,    59,    59
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     2,     3,     2,     1,     2,     1,     2,     3,
+       1,     2,     1,     1,     1,     1,     2,     2,     2,     2,
+       2,     1,     1,     1,     1,     1,     1,     2,     2,     1,
+       2,     2,     6,     6,     6,     6,     6,     6,     2,     2,
+       4,     4,     4,     4,     4,     4,     4,     4,     4,     4,
+       4,     5,     5,     4,     4,     4,     6,     8,     8,     5,
+       5,     4,     4,     4,     6,     8,     8,     4,     4,     1,
+       3,     1,     3,     1,     3
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
+{
+  YY_USE (yyvaluep);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 5: /* endls: TOKEN_ENDL  */
+#line 82 "misc/parser.y"
+               {
+        currentLine = currentLine + 1;
+    }
+#line 1256 "src/parser.cpp"
+    break;
+
+  case 6: /* endls: endls TOKEN_ENDL  */
+#line 85 "misc/parser.y"
+                       {
+        currentLine = currentLine + 1;
+    }
+#line 1264 "src/parser.cpp"
+    break;
+
+  case 13: /* label: TOKEN_LABEL  */
+#line 94 "misc/parser.y"
+                {
+        std::string labelName = labelToString((yyvsp[0].symbol));
+        Assembler::getInstance().handleLabel(labelName, currentLine);
+        delete (yyvsp[0].symbol);
+    }
+#line 1274 "src/parser.cpp"
+    break;
+
+  case 16: /* directive: TOKEN_GLOBAL list_of_symbols  */
+#line 104 "misc/parser.y"
+                                 {
+        Assembler::getInstance().handleGlobal(args, currentLine);
+        deallocArgs();
+    }
+#line 1283 "src/parser.cpp"
+    break;
+
+  case 17: /* directive: TOKEN_EXTERN list_of_symbols  */
+#line 108 "misc/parser.y"
+                                   {
+        Assembler::getInstance().handleExtern(args, currentLine);
+        deallocArgs();
+    }
+#line 1292 "src/parser.cpp"
+    break;
+
+  case 18: /* directive: TOKEN_SECTION TOKEN_SYMBOL  */
+#line 112 "misc/parser.y"
+                                 {
+        std::string name = dereferenceStringPointer((yyvsp[0].symbol));
+        Assembler::getInstance().handleSection(name, currentLine);
+        delete (yyvsp[0].symbol);
+    }
+#line 1302 "src/parser.cpp"
+    break;
+
+  case 19: /* directive: TOKEN_WORD list_of_literals_and_syms  */
+#line 117 "misc/parser.y"
+                                           {
+        Assembler::getInstance().handleWord(args, currentLine);
+        deallocArgs();
+    }
+#line 1311 "src/parser.cpp"
+    break;
+
+  case 20: /* directive: TOKEN_SKIP TOKEN_LITERAL  */
+#line 121 "misc/parser.y"
+                               {
+        Assembler::getInstance().handleSkip((yyvsp[0].number), currentLine);
+    }
+#line 1319 "src/parser.cpp"
+    break;
+
+  case 21: /* directive: TOKEN_ASCII  */
+#line 124 "misc/parser.y"
+                  {
+    }
+#line 1326 "src/parser.cpp"
+    break;
+
+  case 22: /* directive: TOKEN_EQU  */
+#line 126 "misc/parser.y"
+                {
+    }
+#line 1333 "src/parser.cpp"
+    break;
+
+  case 23: /* directive: TOKEN_END  */
+#line 128 "misc/parser.y"
+                {
+        Assembler::getInstance().handleEnd(currentLine);
+    }
+#line 1341 "src/parser.cpp"
+    break;
+
+  case 24: /* instruction: TOKEN_HALT  */
+#line 133 "misc/parser.y"
+               {
+        Assembler::getInstance().handleHaltInstruction(INSTR_NAME::HALT1, currentLine);
+    }
+#line 1349 "src/parser.cpp"
+    break;
+
+  case 25: /* instruction: TOKEN_INT  */
+#line 136 "misc/parser.y"
+                {
+        Assembler::getInstance().handleInterruptInstruction(INSTR_NAME::INT1, currentLine);
+    }
+#line 1357 "src/parser.cpp"
+    break;
+
+  case 26: /* instruction: TOKEN_IRET  */
+#line 139 "misc/parser.y"
+                 {
+        Assembler::getInstance().handleReturnInstruction(INSTR_NAME::IRET1, currentLine);
+    }
+#line 1365 "src/parser.cpp"
+    break;
+
+  case 27: /* instruction: TOKEN_CALL TOKEN_LITERAL  */
+#line 142 "misc/parser.y"
+                               {
+        Assembler::getInstance().handleCallInstruction(INSTR_NAME::CALL1, ARG_TYPE::NUMBER, (yyvsp[0].number), "", currentLine);
+    }
+#line 1373 "src/parser.cpp"
+    break;
+
+  case 28: /* instruction: TOKEN_CALL TOKEN_SYMBOL  */
+#line 145 "misc/parser.y"
+                              {
+        std::string sym = dereferenceStringPointer((yyvsp[0].symbol));
+        Assembler::getInstance().handleCallInstruction(INSTR_NAME::CALL1, ARG_TYPE::SYMBOL, 0, sym, currentLine);
+    }
+#line 1382 "src/parser.cpp"
+    break;
+
+  case 29: /* instruction: TOKEN_RET  */
+#line 149 "misc/parser.y"
+                {
+        Assembler::getInstance().handleReturnInstruction(INSTR_NAME::RET1, currentLine);
+    }
+#line 1390 "src/parser.cpp"
+    break;
+
+  case 30: /* instruction: TOKEN_JMP TOKEN_LITERAL  */
+#line 152 "misc/parser.y"
+                              {
+        Assembler::getInstance().handleJumpInstruction(INSTR_NAME::JMP1, ARG_TYPE::NUMBER, 0, 0, (yyvsp[0].number), "", currentLine);
+    }
+#line 1398 "src/parser.cpp"
+    break;
+
+  case 31: /* instruction: TOKEN_JMP TOKEN_SYMBOL  */
+#line 155 "misc/parser.y"
+                             {
+        std::string sym = dereferenceStringPointer((yyvsp[0].symbol));
+        Assembler::getInstance().handleJumpInstruction(INSTR_NAME::JMP1, ARG_TYPE::SYMBOL, 0, 0, 0, sym, currentLine);
+        delete (yyvsp[0].symbol);
+    }
+#line 1408 "src/parser.cpp"
+    break;
+
+  case 32: /* instruction: TOKEN_BEQ TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_LITERAL  */
+#line 160 "misc/parser.y"
+                                                                                          {
+        Assembler::getInstance().handleJumpInstruction(INSTR_NAME::BEQ1, ARG_TYPE::NUMBER, (yyvsp[-4].number), (yyvsp[-2].number), (yyvsp[0].number), "", currentLine);
+    }
+#line 1416 "src/parser.cpp"
+    break;
+
+  case 33: /* instruction: TOKEN_BEQ TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_SYMBOL  */
+#line 163 "misc/parser.y"
+                                                                                         {
+        std::string sym = dereferenceStringPointer((yyvsp[0].symbol));
+        Assembler::getInstance().handleJumpInstruction(INSTR_NAME::BEQ1, ARG_TYPE::SYMBOL, (yyvsp[-4].number), (yyvsp[-2].number), 0, sym, currentLine);
+        delete (yyvsp[0].symbol);
+    }
+#line 1426 "src/parser.cpp"
+    break;
+
+  case 34: /* instruction: TOKEN_BNE TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_LITERAL  */
+#line 168 "misc/parser.y"
+                                                                                          {
+        Assembler::getInstance().handleJumpInstruction(INSTR_NAME::BNE1, ARG_TYPE::NUMBER, (yyvsp[-4].number), (yyvsp[-2].number), (yyvsp[0].number), "", currentLine);
+    }
+#line 1434 "src/parser.cpp"
+    break;
+
+  case 35: /* instruction: TOKEN_BNE TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_SYMBOL  */
+#line 171 "misc/parser.y"
+                                                                                         {
+        std::string sym = dereferenceStringPointer((yyvsp[0].symbol));
+        Assembler::getInstance().handleJumpInstruction(INSTR_NAME::BNE1, ARG_TYPE::SYMBOL, (yyvsp[-4].number), (yyvsp[-2].number), 0, sym, currentLine);
+        delete (yyvsp[0].symbol);
+    }
+#line 1444 "src/parser.cpp"
+    break;
+
+  case 36: /* instruction: TOKEN_BGT TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_LITERAL  */
+#line 176 "misc/parser.y"
+                                                                                          {
+        Assembler::getInstance().handleJumpInstruction(INSTR_NAME::BGT1, ARG_TYPE::NUMBER, (yyvsp[-4].number), (yyvsp[-2].number), (yyvsp[0].number), "", currentLine);
+    }
+#line 1452 "src/parser.cpp"
+    break;
+
+  case 37: /* instruction: TOKEN_BGT TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_SYMBOL  */
+#line 179 "misc/parser.y"
+                                                                                         {
+        std::string sym = dereferenceStringPointer((yyvsp[0].symbol));
+        Assembler::getInstance().handleJumpInstruction(INSTR_NAME::BGT1, ARG_TYPE::SYMBOL, (yyvsp[-4].number), (yyvsp[-2].number), 0, sym, currentLine);
+        delete (yyvsp[0].symbol);
+    }
+#line 1462 "src/parser.cpp"
+    break;
+
+  case 38: /* instruction: TOKEN_PUSH TOKEN_GP_REGISTER  */
+#line 184 "misc/parser.y"
+                                   {
+        Assembler::getInstance().handleStackInstruction(INSTR_NAME::PUSH1, (yyvsp[0].number), currentLine);
+    }
+#line 1470 "src/parser.cpp"
+    break;
+
+  case 39: /* instruction: TOKEN_POP TOKEN_GP_REGISTER  */
+#line 187 "misc/parser.y"
+                                  {
+        Assembler::getInstance().handleStackInstruction(INSTR_NAME::POP1, (yyvsp[0].number), currentLine);
+    }
+#line 1478 "src/parser.cpp"
+    break;
+
+  case 40: /* instruction: TOKEN_XCHG TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 190 "misc/parser.y"
+                                                                 {
+        Assembler::getInstance().handleXCHGInstruction(INSTR_NAME::XCHG1, (yyvsp[-2].number), (yyvsp[0].number), currentLine);
+    }
+#line 1486 "src/parser.cpp"
+    break;
+
+  case 41: /* instruction: TOKEN_ADD TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 193 "misc/parser.y"
+                                                                {
+        Assembler::getInstance().handleArithmeticInstruction(INSTR_NAME::ADD1, (yyvsp[-2].number), (yyvsp[0].number), currentLine);
+    }
+#line 1494 "src/parser.cpp"
+    break;
+
+  case 42: /* instruction: TOKEN_SUB TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 196 "misc/parser.y"
+                                                                {
+        Assembler::getInstance().handleArithmeticInstruction(INSTR_NAME::SUB1, (yyvsp[-2].number), (yyvsp[0].number), currentLine);
+    }
+#line 1502 "src/parser.cpp"
+    break;
+
+  case 43: /* instruction: TOKEN_MUL TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 199 "misc/parser.y"
+                                                                {
+        Assembler::getInstance().handleArithmeticInstruction(INSTR_NAME::MUL1, (yyvsp[-2].number), (yyvsp[0].number), currentLine);
+    }
+#line 1510 "src/parser.cpp"
+    break;
+
+  case 44: /* instruction: TOKEN_DIV TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 202 "misc/parser.y"
+                                                                {
+        Assembler::getInstance().handleArithmeticInstruction(INSTR_NAME::DIV1, (yyvsp[-2].number), (yyvsp[0].number), currentLine);
+    }
+#line 1518 "src/parser.cpp"
+    break;
+
+  case 45: /* instruction: TOKEN_NOT TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 205 "misc/parser.y"
+                                                                {
+        Assembler::getInstance().handleLogicInstruction(INSTR_NAME::NOT1, (yyvsp[-2].number), (yyvsp[0].number), currentLine);
+    }
+#line 1526 "src/parser.cpp"
+    break;
+
+  case 46: /* instruction: TOKEN_AND TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 208 "misc/parser.y"
+                                                                {
+        Assembler::getInstance().handleLogicInstruction(INSTR_NAME::AND1, (yyvsp[-2].number), (yyvsp[0].number), currentLine);
+    }
+#line 1534 "src/parser.cpp"
+    break;
+
+  case 47: /* instruction: TOKEN_OR TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 211 "misc/parser.y"
+                                                               {
+        Assembler::getInstance().handleLogicInstruction(INSTR_NAME::OR1, (yyvsp[-2].number), (yyvsp[0].number), currentLine);
+    }
+#line 1542 "src/parser.cpp"
+    break;
+
+  case 48: /* instruction: TOKEN_XOR TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 214 "misc/parser.y"
+                                                                {
+        Assembler::getInstance().handleLogicInstruction(INSTR_NAME::XOR1, (yyvsp[-2].number), (yyvsp[0].number), currentLine);
+    }
+#line 1550 "src/parser.cpp"
+    break;
+
+  case 49: /* instruction: TOKEN_SHL TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 217 "misc/parser.y"
+                                                                {
+        Assembler::getInstance().handleShiftInstruction(INSTR_NAME::SHL1, (yyvsp[-2].number), (yyvsp[0].number), currentLine);
+    }
+#line 1558 "src/parser.cpp"
+    break;
+
+  case 50: /* instruction: TOKEN_SHR TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 220 "misc/parser.y"
+                                                                {
+        Assembler::getInstance().handleShiftInstruction(INSTR_NAME::SHR1, (yyvsp[-2].number), (yyvsp[0].number), currentLine);
+    }
+#line 1566 "src/parser.cpp"
+    break;
+
+  case 51: /* instruction: TOKEN_LD TOKEN_IMM TOKEN_LITERAL TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 223 "misc/parser.y"
+                                                                     {
+        Assembler::getInstance().handleLoadInstruction(INSTR_NAME::LD1, ADDR_TYPE::IMMED, ARG_TYPE::NUMBER, 0, (yyvsp[0].number), (yyvsp[-2].number), "", currentLine);
+    }
+#line 1574 "src/parser.cpp"
+    break;
+
+  case 52: /* instruction: TOKEN_LD TOKEN_IMM TOKEN_SYMBOL TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 226 "misc/parser.y"
+                                                                    {
+        std::string sym = dereferenceStringPointer((yyvsp[-2].symbol));
+        Assembler::getInstance().handleLoadInstruction(INSTR_NAME::LD1, ADDR_TYPE::IMMED, ARG_TYPE::SYMBOL, 0, (yyvsp[0].number), 0, sym, currentLine);
+        delete (yyvsp[-2].symbol);
+    }
+#line 1584 "src/parser.cpp"
+    break;
+
+  case 53: /* instruction: TOKEN_LD TOKEN_LITERAL TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 231 "misc/parser.y"
+                                                           {
+        Assembler::getInstance().handleLoadInstruction(INSTR_NAME::LD1, ADDR_TYPE::MEMDIR, ARG_TYPE::NUMBER, 0, (yyvsp[0].number), (yyvsp[-2].number), "", currentLine);
+    }
+#line 1592 "src/parser.cpp"
+    break;
+
+  case 54: /* instruction: TOKEN_LD TOKEN_SYMBOL TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 234 "misc/parser.y"
+                                                          {
+        std::string sym = dereferenceStringPointer((yyvsp[-2].symbol));
+        Assembler::getInstance().handleLoadInstruction(INSTR_NAME::LD1, ADDR_TYPE::MEMDIR, ARG_TYPE::SYMBOL, 0, (yyvsp[0].number), 0, sym, currentLine);
+        delete (yyvsp[-2].symbol);
+    }
+#line 1602 "src/parser.cpp"
+    break;
+
+  case 55: /* instruction: TOKEN_LD TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 239 "misc/parser.y"
+                                                               {
+        Assembler::getInstance().handleLoadInstruction(INSTR_NAME::LD1, ADDR_TYPE::REGDIR, ARG_TYPE::NUMBER, (yyvsp[-2].number), (yyvsp[0].number), 0, "", currentLine);
+    }
+#line 1610 "src/parser.cpp"
+    break;
+
+  case 56: /* instruction: TOKEN_LD TOKEN_LEFT_BRACKET TOKEN_GP_REGISTER TOKEN_RIGHT_BRACKET TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 242 "misc/parser.y"
+                                                                                                      {
+        Assembler::getInstance().handleLoadInstruction(INSTR_NAME::LD1, ADDR_TYPE::REGIND, ARG_TYPE::NUMBER, (yyvsp[-3].number), (yyvsp[0].number), 0, "", currentLine);
+    }
+#line 1618 "src/parser.cpp"
+    break;
+
+  case 57: /* instruction: TOKEN_LD TOKEN_LEFT_BRACKET TOKEN_GP_REGISTER TOKEN_PLUS TOKEN_LITERAL TOKEN_RIGHT_BRACKET TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 245 "misc/parser.y"
+                                                                                                                               {
+        Assembler::getInstance().handleLoadInstruction(INSTR_NAME::LD1, ADDR_TYPE::REGINDPOM, ARG_TYPE::NUMBER, (yyvsp[-5].number), (yyvsp[0].number), (yyvsp[-3].number), "", currentLine);
+    }
+#line 1626 "src/parser.cpp"
+    break;
+
+  case 58: /* instruction: TOKEN_LD TOKEN_LEFT_BRACKET TOKEN_GP_REGISTER TOKEN_PLUS TOKEN_SYMBOL TOKEN_RIGHT_BRACKET TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 248 "misc/parser.y"
+                                                                                                                              {
+        std::string sym = dereferenceStringPointer((yyvsp[-3].symbol));
+        Assembler::getInstance().handleLoadInstruction(INSTR_NAME::LD1, ADDR_TYPE::REGINDPOM, ARG_TYPE::SYMBOL, (yyvsp[-5].number), (yyvsp[0].number), 0, sym, currentLine);
+        delete (yyvsp[-3].symbol);
+    }
+#line 1636 "src/parser.cpp"
+    break;
+
+  case 59: /* instruction: TOKEN_ST TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_IMM TOKEN_LITERAL  */
+#line 253 "misc/parser.y"
+                                                                     {
+        Assembler::getInstance().handleStoreInstruction(INSTR_NAME::ST1, ADDR_TYPE::IMMED, ARG_TYPE::NUMBER, (yyvsp[-3].number), 0, (yyvsp[0].number), "", currentLine);
+    }
+#line 1644 "src/parser.cpp"
+    break;
+
+  case 60: /* instruction: TOKEN_ST TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_IMM TOKEN_SYMBOL  */
+#line 256 "misc/parser.y"
+                                                                    {
+        std::string sym = dereferenceStringPointer((yyvsp[0].symbol));
+        Assembler::getInstance().handleStoreInstruction(INSTR_NAME::ST1, ADDR_TYPE::IMMED, ARG_TYPE::SYMBOL, (yyvsp[-3].number), 0, 0, sym, currentLine);
+        delete (yyvsp[0].symbol);
+    }
+#line 1654 "src/parser.cpp"
+    break;
+
+  case 61: /* instruction: TOKEN_ST TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_LITERAL  */
+#line 261 "misc/parser.y"
+                                                           {
+        Assembler::getInstance().handleStoreInstruction(INSTR_NAME::ST1, ADDR_TYPE::MEMDIR, ARG_TYPE::NUMBER, (yyvsp[-2].number), 0, (yyvsp[0].number), "", currentLine);
+    }
+#line 1662 "src/parser.cpp"
+    break;
+
+  case 62: /* instruction: TOKEN_ST TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_SYMBOL  */
+#line 264 "misc/parser.y"
+                                                          {
+        std::string sym = dereferenceStringPointer((yyvsp[0].symbol));
+        Assembler::getInstance().handleStoreInstruction(INSTR_NAME::ST1, ADDR_TYPE::MEMDIR, ARG_TYPE::SYMBOL, (yyvsp[-2].number), 0, 0, sym, currentLine);
+        delete (yyvsp[0].symbol);
+    }
+#line 1672 "src/parser.cpp"
+    break;
+
+  case 63: /* instruction: TOKEN_ST TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 269 "misc/parser.y"
+                                                               {
+        Assembler::getInstance().handleStoreInstruction(INSTR_NAME::ST1, ADDR_TYPE::REGDIR, ARG_TYPE::NUMBER, (yyvsp[-2].number), (yyvsp[0].number), 0, "", currentLine);
+    }
+#line 1680 "src/parser.cpp"
+    break;
+
+  case 64: /* instruction: TOKEN_ST TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_LEFT_BRACKET TOKEN_GP_REGISTER TOKEN_RIGHT_BRACKET  */
+#line 272 "misc/parser.y"
+                                                                                                      {
+        Assembler::getInstance().handleStoreInstruction(INSTR_NAME::ST1, ADDR_TYPE::REGIND, ARG_TYPE::NUMBER, (yyvsp[-4].number), (yyvsp[-1].number), 0, "", currentLine);
+    }
+#line 1688 "src/parser.cpp"
+    break;
+
+  case 65: /* instruction: TOKEN_ST TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_LEFT_BRACKET TOKEN_GP_REGISTER TOKEN_PLUS TOKEN_LITERAL TOKEN_RIGHT_BRACKET  */
+#line 275 "misc/parser.y"
+                                                                                                                               {
+        Assembler::getInstance().handleStoreInstruction(INSTR_NAME::ST1, ADDR_TYPE::REGINDPOM, ARG_TYPE::NUMBER, (yyvsp[-6].number), (yyvsp[-3].number), (yyvsp[-1].number), "", currentLine);
+    }
+#line 1696 "src/parser.cpp"
+    break;
+
+  case 66: /* instruction: TOKEN_ST TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_LEFT_BRACKET TOKEN_GP_REGISTER TOKEN_PLUS TOKEN_SYMBOL TOKEN_RIGHT_BRACKET  */
+#line 278 "misc/parser.y"
+                                                                                                                              {
+        std::string sym = dereferenceStringPointer((yyvsp[-1].symbol));
+        Assembler::getInstance().handleStoreInstruction(INSTR_NAME::ST1, ADDR_TYPE::REGINDPOM, ARG_TYPE::SYMBOL, (yyvsp[-6].number), (yyvsp[-3].number), 0, sym, currentLine);
+        delete (yyvsp[-1].symbol);
+    }
+#line 1706 "src/parser.cpp"
+    break;
+
+  case 67: /* instruction: TOKEN_CSRRD TOKEN_CS_REGISTER TOKEN_COMMA TOKEN_GP_REGISTER  */
+#line 283 "misc/parser.y"
+                                                                  {
+        Assembler::getInstance().handleCSRInstruction(INSTR_NAME::CSRRD1, (yyvsp[0].number), (yyvsp[-2].number), currentLine);
+    }
+#line 1714 "src/parser.cpp"
+    break;
+
+  case 68: /* instruction: TOKEN_CSRWR TOKEN_GP_REGISTER TOKEN_COMMA TOKEN_CS_REGISTER  */
+#line 286 "misc/parser.y"
+                                                                  {
+        Assembler::getInstance().handleCSRInstruction(INSTR_NAME::CSRWR1, (yyvsp[0].number), (yyvsp[-2].number), currentLine);
+    }
+#line 1722 "src/parser.cpp"
+    break;
+
+  case 69: /* list_of_literals_and_syms: TOKEN_SYMBOL  */
+#line 294 "misc/parser.y"
+                 {
+        addSymbolToArgs((yyvsp[0].symbol));    // u "args" se nalaze argumenti
+    }
+#line 1730 "src/parser.cpp"
+    break;
+
+  case 70: /* list_of_literals_and_syms: list_of_literals_and_syms TOKEN_COMMA TOKEN_SYMBOL  */
+#line 297 "misc/parser.y"
+                                                         {
+        addSymbolToArgs((yyvsp[0].symbol));    // u "args" se nalaze argumenti
+    }
+#line 1738 "src/parser.cpp"
+    break;
+
+  case 71: /* list_of_literals_and_syms: TOKEN_LITERAL  */
+#line 300 "misc/parser.y"
+                    {
+        addLiteralToArgs((yyvsp[0].number));   // u "args" se nalaze argumenti
+    }
+#line 1746 "src/parser.cpp"
+    break;
+
+  case 72: /* list_of_literals_and_syms: list_of_literals_and_syms TOKEN_COMMA TOKEN_LITERAL  */
+#line 303 "misc/parser.y"
+                                                          {
+        addLiteralToArgs((yyvsp[0].number));   // u "args" se nalaze argumenti
+    }
+#line 1754 "src/parser.cpp"
+    break;
+
+  case 73: /* list_of_symbols: TOKEN_SYMBOL  */
+#line 308 "misc/parser.y"
+                 {
+        addSymbolToArgs((yyvsp[0].symbol));    // u "args" se nalaze argumenti
+    }
+#line 1762 "src/parser.cpp"
+    break;
+
+  case 74: /* list_of_symbols: list_of_symbols TOKEN_COMMA TOKEN_SYMBOL  */
+#line 311 "misc/parser.y"
+                                               {
+        addSymbolToArgs((yyvsp[0].symbol));    // u "args" se nalaze argumenti
+    }
+#line 1770 "src/parser.cpp"
+    break;
+
+
+#line 1774 "src/parser.cpp"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
@@ -0,0 +1,159 @@
+#include "../inc/profiler.hpp"
+#include "../inc/emulator.hpp"
+#include <algorithm>
+
+Profiler::Profiler() {
+  clear();
+}
+
+// Both the .sym and the .map file will do.
+bool Profiler::loadSymbols(std::string file) {
+  if (!symbols.load(file)) return false;
+
+  // already in address order, with a global after the section it starts at, so the global names the function
+  functions.clear();
+  for (int i = 0; i < symbols.getSymbols().size(); i++) {
+    const MapSymbol& symbol = symbols.getSymbols().at(i);
+    if (symbol.kind == 'g' || symbol.kind == 's') functions.push_back(symbol);
+  }
+  return true;
+}
+
+void Profiler::clear() {
+  pcCounts.clear();
+  for (int i = 0; i < 256; i++) opcodeCounts[i] = 0;
+  callEdges.clear();
+  nodes.clear();
+  current = -1;
+}
+
+void Profiler::start(unsigned int pc) {
+  if (!nodes.empty()) return;
+  ProfileNode root;
+  root.symbol = functionAt(pc);
+  root.parent = -1;
+  root.instructions = 0;
+  nodes.push_back(root);
+  current = 0;
+}
+
+// Last symbol at or below pc, for equal addresses the later one (the global over its section).
+int Profiler::functionAt(unsigned int pc) const {
+  auto it = std::upper_bound(functions.begin(), functions.end(), pc,
+                             [](unsigned int address, const MapSymbol& symbol) { return address < symbol.address; });
+  if (it == functions.begin()) return -1;
+  return (it - functions.begin()) - 1;
+}
+
+std::string Profiler::functionName(int function) const {
+  if (function < 0) return "[unknown]";
+  return functions.at(function).name;
+}
+
+void Profiler::recordBlock(Block* block, unsigned int exitIndex, int exitSlot, unsigned int nextPc) {
+  const MicroOp& exitOp = block->ops[exitIndex];
+  block->profile[exitOp.retired]++;
+  nodes[current].instructions += exitOp.retired;
+
+  if (exitSlot == 0 && (exitOp.handler == H_CALL_MEM_A_B_D || exitOp.handler == H_INT)) {
+    call(nextPc);
+  } else if (exitOp.handler == H_EXIT_DYNAMIC && exitIndex > 0
+             && block->ops[exitIndex - 1].handler == H_POP && block->ops[exitIndex - 1].a == PC) {
+    ret(); // "ret" and the second half of "iret"
+  }
+}
+
+void Profiler::call(unsigned int target) {
+  int callee = functionAt(target);
+  callEdges[std::make_pair(nodes[current].symbol, callee)]++;
+
+  auto it = nodes[current].children.find(callee);
+  if (it != nodes[current].children.end()) {
+    current = it->second;
+    return;
+  }
+
+  ProfileNode node;
+  node.symbol = callee;
+  node.parent = current;
+  node.instructions = 0;
+  nodes.push_back(node);
+  int index = nodes.size() - 1;
+  nodes[current].children[callee] = index;
+  current = index;
+}
+
+void Profiler::ret() {
+  if (nodes[current].parent >= 0) current = nodes[current].parent;
+}
+
+// Instruction k of the block retired in every run that got further than k instructions.
+void Profiler::foldBlock(Block* block) {
+  unsigned long long reached = 0;
+  for (int k = block->instructions - 1; k >= 0; k--) {
+    reached += block->profile[k + 1];
+    if (reached == 0) continue;
+    pcCounts[block->startPc + 4 * k] += reached;
+    opcodeCounts[block->opcodes[k]] += reached;
+  }
+  std::fill(block->profile.begin(), block->profile.end(), 0);
+}
+
+bool Profiler::write(std::string flatFile, std::string foldedFile) {
+  std::ofstream flat(flatFile, std::ios::out);
+  std::ofstream folded(foldedFile, std::ios::out);
+  if (!flat || !folded) return false;
+
+  unsigned long long total = 0;
+  std::map<int, unsigned long long> perFunction;
+  std::vector<std::pair<unsigned long long, unsigned int>> hottest;
+  for (auto it = pcCounts.begin(); it != pcCounts.end(); it++) {
+    total += it->second;
+    perFunction[functionAt(it->first)] += it->second;
+    hottest.push_back(std::make_pair(it->second, it->first));
+  }
+
+  flat << "Flat profile, " << std::dec << total << " instructions retired\n";
+  flat << "       %  instructions  symbol\n";
+  std::vector<std::pair<unsigned long long, int>> functionsByCount;
+  for (auto it = perFunction.begin(); it != perFunction.end(); it++) functionsByCount.push_back(std::make_pair(it->second, it->first));
+  std::sort(functionsByCount.rbegin(), functionsByCount.rend());
+  for (int i = 0; i < functionsByCount.size(); i++) {
+    flat << std::setw(8) << std::fixed << std::setprecision(2) << 100.0 * functionsByCount.at(i).first / total
+         << std::setw(14) << functionsByCount.at(i).first << "  " << functionName(functionsByCount.at(i).second) << "\n";
+  }
+
+  flat << "\nHottest instructions\n";
+  flat << "  instructions  address     location\n";
+  std::sort(hottest.begin(), hottest.end(), [](const std::pair<unsigned long long, unsigned int>& x,
+                                               const std::pair<unsigned long long, unsigned int>& y) {
+    return x.first > y.first || (x.first == y.first && x.second < y.second);
+  });
+  for (int i = 0; i < hottest.size() && i < 20; i++) {
+    flat << std::dec << std::setw(14) << hottest.at(i).first << "  0x" << std::setw(8) << std::setfill('0') << std::hex
+         << hottest.at(i).second << std::setfill(' ') << "  " << symbols.location(hottest.at(i).second) << "\n";
+  }
+
+  flat << "\nInstructions per opcode\n";
+  for (int i = 0; i < 256; i++) {
+    if (opcodeCounts[i] == 0) continue;
+    flat << "  " << std::left << std::setw(12) << opcodeName(i) << std::right << std::dec << std::setw(14) << opcodeCounts[i] << "\n";
+  }
+
+  flat << "\nCall edges\n";
+  for (auto it = callEdges.begin(); it != callEdges.end(); it++) {
+    flat << std::dec << std::setw(14) << it->second << "  " << functionName(it->first.first) << " -> "
+         << functionName(it->first.second) << "\n";
+  }
+
+  // one "root;caller;callee count" line per call tree node that retired anything itself
+  for (int i = 0; i < nodes.size(); i++) {
+    if (nodes.at(i).instructions == 0) continue;
+    std::string stack = functionName(nodes.at(i).symbol);
+    for (int parent = nodes.at(i).parent; parent >= 0; parent = nodes.at(parent).parent) {
+      stack = functionName(nodes.at(parent).symbol) + ";" + stack;
+    }
+    folded << stack << " " << std::dec << nodes.at(i).instructions << "\n";
+  }
+  return true;
+}
@@ -0,0 +1,28 @@
+#include "../inc/snapshot.hpp"
+#include <unistd.h>
+#include <sys/mman.h>
+
+size_t snapshotDataOffset(unsigned int pages) {
+  size_t size = sizeof(SnapshotHeader) + (size_t)pages * sizeof(SnapshotPage);
+  return (size + GUEST_PAGE_SIZE - 1) & ~(size_t)(GUEST_PAGE_SIZE - 1);
+}
+
+bool writeAll(int fd, const void* data, size_t size) {
+  const char* position = (const char*)data;
+  while (size > 0) {
+    ssize_t count = write(fd, position, size);
+    if (count <= 0) return false;
+    position += count;
+    size -= count;
+  }
+  return true;
+}
+
+Snapshot::Snapshot() {
+  fd = memfd_create("snapshot", MFD_CLOEXEC);
+  size = 0;
+}
+
+Snapshot::~Snapshot() {
+  if (fd >= 0) close(fd);
+}
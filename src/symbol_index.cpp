@@ -0,0 +1,99 @@
+#include "../inc/symbol_index.hpp"
+
+#define EMPTY_KEY (~0ull)
+#define INITIAL_SLOTS 64
+
+// FNV-1a
+static unsigned int hashString(std::string_view str) {
+  unsigned int hash = 2166136261u;
+  for (int i = 0; i < str.size(); i++) {
+    hash = (hash ^ (unsigned char)str[i]) * 16777619u;
+  }
+  return hash;
+}
+
+StringTable::StringTable() : slots(INITIAL_SLOTS, -1) {}
+
+int StringTable::intern(std::string_view str) {
+  unsigned int hash = hashString(str);
+  unsigned int i = probeStart(hash);
+  while (slots[i] != -1) {
+    int id = slots[i];
+    if (hashes[id] == hash && strings[id] == str) return id;
+    i = (i + 1) & (slots.size() - 1);
+  }
+
+  int id = strings.size();
+  strings.push_back(std::string(str));
+  hashes.push_back(hash);
+  slots[i] = id;
+  if (2 * strings.size() > slots.size()) grow();
+  return id;
+}
+
+int StringTable::find(std::string_view str) const {
+  unsigned int hash = hashString(str);
+  for (unsigned int i = probeStart(hash); slots[i] != -1; i = (i + 1) & (slots.size() - 1)) {
+    int id = slots[i];
+    if (hashes[id] == hash && strings[id] == str) return id;
+  }
+  return -1;
+}
+
+void StringTable::grow() {
+  slots.assign(slots.size() * 2, -1);
+  for (int id = 0; id < strings.size(); id++) {
+    unsigned int i = probeStart(hashes[id]);
+    while (slots[i] != -1) i = (i + 1) & (slots.size() - 1);
+    slots[i] = id;
+  }
+}
+
+SymbolIndex::SymbolIndex() {
+  clear();
+}
+
+void SymbolIndex::clear() {
+  slots.assign(INITIAL_SLOTS, Slot{EMPTY_KEY, 0});
+  used = 0;
+}
+
+// multiplicative hashing, the top bits of the product are the best mixed
+unsigned int SymbolIndex::probeStart(unsigned long long key) const {
+  return (unsigned int)((key * 0x9e3779b97f4a7c15ull) >> 32) & (slots.size() - 1);
+}
+
+bool SymbolIndex::insert(int scope, int nameId, int value) {
+  unsigned long long key = makeKey(scope, nameId);
+  unsigned int i = probeStart(key);
+  while (slots[i].key != EMPTY_KEY) {
+    if (slots[i].key == key) return false;
+    i = (i + 1) & (slots.size() - 1);
+  }
+
+  slots[i].key = key;
+  slots[i].value = value;
+  used++;
+  if (2 * used > slots.size()) grow();
+  return true;
+}
+
+int SymbolIndex::find(int scope, int nameId) const {
+  unsigned long long key = makeKey(scope, nameId);
+  for (unsigned int i = probeStart(key); slots[i].key != EMPTY_KEY; i = (i + 1) & (slots.size() - 1)) {
+    if (slots[i].key == key) return slots[i].value;
+  }
+  return -1;
+}
+
+void SymbolIndex::grow() {
+  std::vector<Slot> old;
+  old.swap(slots);
+  slots.assign(old.size() * 2, Slot{EMPTY_KEY, 0});
+  for (int j = 0; j < old.size(); j++) {
+    if (old[j].key == EMPTY_KEY) continue;
+    unsigned int i = probeStart(old[j].key);
+    while (slots[i].key != EMPTY_KEY) i = (i + 1) & (slots.size() - 1);
+    slots[i] = old[j];
+  }
+}
@@ -0,0 +1,67 @@
+#include "../inc/symbol_map.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+bool SymbolMap::load(const std::string& file) {
+  std::ifstream input(file);
+  if (!input) return false;
+  symbols.clear();
+  sections.clear();
+
+  std::string line;
+  while (std::getline(input, line)) {
+    std::stringstream ss(line);
+    std::string first;
+    if (!(ss >> first)) continue;
+
+    if (first == "section") {
+      MapSection section;
+      if (ss >> std::hex >> section.address >> section.size >> section.name) sections.push_back(section);
+      continue;
+    }
+    if (first == "part") continue;
+
+    // a .map symbol line has the address after the keyword, a .sym line starts with it
+    MapSymbol symbol;
+    if (first == "symbol") {
+      if (!(ss >> std::hex >> symbol.address)) continue;
+    } else {
+      std::stringstream address(first);
+      if (!(address >> std::hex >> symbol.address)) continue;
+    }
+    if (!(ss >> symbol.kind >> symbol.name)) continue;
+    symbols.push_back(symbol);
+  }
+
+  std::sort(symbols.begin(), symbols.end(), [](const MapSymbol& x, const MapSymbol& y) {
+    return x.address < y.address || (x.address == y.address && x.kind == 's' && y.kind != 's');
+  });
+  std::sort(sections.begin(), sections.end(), [](const MapSection& x, const MapSection& y) {
+    return x.address < y.address;
+  });
+  return true;
+}
+
+int SymbolMap::symbolAt(unsigned int address) const {
+  auto it = std::upper_bound(symbols.begin(), symbols.end(), address,
+                             [](unsigned int address, const MapSymbol& symbol) { return address < symbol.address; });
+  return (it - symbols.begin()) - 1;
+}
+
+std::string SymbolMap::location(unsigned int address) const {
+  int k = symbolAt(address);
+  if (k == -1) return "";
+  std::stringstream ss;
+  ss << symbols.at(k).name;
+  if (address != symbols.at(k).address) ss << "+0x" << std::hex << address - symbols.at(k).address;
+  return ss.str();
+}
+
+bool SymbolMap::inSection(unsigned int address) const {
+  auto it = std::upper_bound(sections.begin(), sections.end(), address,
+                             [](unsigned int address, const MapSection& section) { return address < section.address; });
+  if (it == sections.begin()) return false;
+  it--;
+  return address - it->address < it->size;
+}
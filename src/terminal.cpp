@@ -0,0 +1,107 @@
+#include "../inc/terminal.hpp"
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+
+Terminal::Terminal() {
+  running = false;
+  rawMode = false;
+}
+
+Terminal::~Terminal() {
+  stop();
+}
+
+// Keys reach the guest one at a time without echo when stdin is a terminal.
+void Terminal::start() {
+  if (running) return;
+
+  if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &savedAttributes) == 0) {
+    struct termios attributes = savedAttributes;
+    attributes.c_lflag &= ~(ICANON | ECHO);
+    attributes.c_cc[VMIN] = 1;
+    attributes.c_cc[VTIME] = 0;
+    rawMode = tcsetattr(STDIN_FILENO, TCSANOW, &attributes) == 0;
+  }
+
+  running = true;
+  thread = std::thread(&Terminal::run, this);
+}
+
+void Terminal::stop() {
+  if (!running) return;
+  running = false;
+  thread.join();
+
+  if (rawMode) tcsetattr(STDIN_FILENO, TCSANOW, &savedAttributes);
+  rawMode = false;
+}
+
+void Terminal::write(unsigned char c) {
+  if (!running) return; // no console attached
+  // output is full only if the host stopped reading, wait for the I/O thread
+  while (!output.push(c)) std::this_thread::yield();
+}
+
+bool Terminal::read(unsigned char& c) {
+  return input.pop(c);
+}
+
+void Terminal::run() {
+  struct pollfd descriptor;
+  descriptor.fd = STDIN_FILENO;
+
+  // bytes read from stdin that did not fit into the input buffer yet
+  unsigned char pending[256];
+  ssize_t pendingCount = 0;
+  ssize_t pendingPosition = 0;
+
+  while (running) {
+    while (pendingPosition < pendingCount && input.push(pending[pendingPosition])) pendingPosition++;
+    bool canRead = pendingPosition == pendingCount;
+
+    descriptor.events = canRead ? POLLIN : 0;
+    descriptor.revents = 0;
+    if (poll(&descriptor, 1, TERMINAL_POLL_MS) > 0 && canRead) {
+      pendingCount = ::read(STDIN_FILENO, pending, sizeof(pending));
+      pendingPosition = 0;
+      if (pendingCount < 0 && (errno == EINTR || errno == EAGAIN)) {
+        pendingCount = 0; // nothing this time, poll again
+      } else if (pendingCount <= 0) {
+        pendingCount = 0;
+        descriptor.fd = -1; // end of input, poll keeps serving as the wait
+      }
+    }
+    drainOutput();
+  }
+  drainOutput();
+}
+
+// Goes on after short writes and interruptions, waits while a non-blocking stdout is full.
+// Only gives up if stdout is gone.
+static void writeAll(const unsigned char* data, size_t size) {
+  while (size > 0) {
+    ssize_t written = ::write(STDOUT_FILENO, data, size);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      if (errno != EAGAIN) return;
+      struct pollfd descriptor = {STDOUT_FILENO, POLLOUT, 0};
+      poll(&descriptor, 1, TERMINAL_POLL_MS);
+      continue;
+    }
+    data += written;
+    size -= written;
+  }
+}
+
+void Terminal::drainOutput() {
+  unsigned char chunk[TERMINAL_BUFFER_SIZE];
+  size_t size = 0;
+  while (output.pop(chunk[size])) {
+    if (++size == sizeof(chunk)) {
+      writeAll(chunk, size);
+      size = 0;
+    }
+  }
+  if (size != 0) writeAll(chunk, size);
+}
@@ -0,0 +1,57 @@
+#include "../inc/thread_pool.hpp"
+#include <thread>
+
+ThreadPool::ThreadPool(unsigned int threads) {
+  if (threads == 0) threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  for (unsigned int i = 0; i < threads; i++) queues.push_back(std::unique_ptr<Queue>(new Queue()));
+  nextQueue = 0;
+  submitted = 0;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  queues.at(nextQueue)->tasks.push_back(task);
+  nextQueue = (nextQueue + 1) % queues.size();
+  submitted++;
+}
+
+// No more threads than tasks, the calling thread being one of them. Queues without a worker
+// of their own are emptied by stealing.
+void ThreadPool::run() {
+  size_t threads = submitted < queues.size() ? submitted : queues.size();
+  std::vector<std::thread> workers;
+  for (unsigned int i = 1; i < threads; i++) workers.push_back(std::thread(&ThreadPool::work, this, i));
+  work(0);
+  for (int i = 0; i < workers.size(); i++) workers.at(i).join();
+  nextQueue = 0;
+  submitted = 0;
+}
+
+void ThreadPool::work(unsigned int worker) {
+  std::function<void()> task;
+  while (takeTask(worker, task)) task();
+}
+
+// Tasks never submit new ones, so finding every queue empty means the worker is done.
+bool ThreadPool::takeTask(unsigned int worker, std::function<void()>& task) {
+  {
+    Queue& own = *queues.at(worker);
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+
+  for (unsigned int i = 1; i < queues.size(); i++) {
+    Queue& victim = *queues.at((worker + i) % queues.size());
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,30 @@
+#include "../inc/timer.hpp"
+
+static const unsigned long long periodsMs[TIMER_PERIODS_NUM] = {
+  500, 1000, 1500, 2000, 5000, 10000, 30000, 60000
+};
+
+Timer::Timer() {
+  reset();
+}
+
+void Timer::reset() {
+  period = 0;
+  deadline = ~0ULL;
+}
+
+void Timer::configure(unsigned int value, unsigned long long now) {
+  period = periodsMs[value & (TIMER_PERIODS_NUM - 1)] * GUEST_CYCLES_PER_MS;
+  deadline = now + period;
+}
+
+// Ticks missed while the interrupt was masked collapse into the one being delivered.
+void Timer::acknowledge(unsigned long long now) {
+  if (period == 0) return;
+  while (deadline <= now) deadline += period;
+}
+
+void Timer::restore(unsigned long long period, unsigned long long deadline) {
+  this->period = period;
+  this->deadline = deadline;
+}
@@ -0,0 +1,161 @@
+#include "../inc/tracer.hpp"
+#include <cstring>
+#include <chrono>
+
+TraceState::TraceState() {
+  pc = 0 - 4;
+  address = 0;
+  for (int i = 0; i < TRACE_REGISTERS_NUM; i++) registers[i] = 0;
+  // pc 1 is never fetched, so an empty line can't hit
+  for (int i = 0; i < TRACE_WORD_CACHE_SIZE; i++) cachedPcs[i] = 1;
+}
+
+Tracer::Tracer() {
+  chunks = nullptr;
+  current = 0;
+  position = 0;
+  records = 0;
+  bytes = 0;
+  output = nullptr;
+  running = false;
+}
+
+Tracer::~Tracer() {
+  stop();
+  delete[] chunks;
+}
+
+bool Tracer::start(std::string file) {
+  output = fopen(file.c_str(), "wb");
+  if (output == nullptr) return false;
+  fwrite(TRACE_MAGIC, 1, strlen(TRACE_MAGIC), output);
+
+  if (chunks == nullptr) chunks = new unsigned char[(size_t)TRACE_CHUNKS * TRACE_CHUNK_SIZE];
+  // chunk 0 is being filled, the rest wait in the free queue
+  for (int i = 1; i < TRACE_CHUNKS; i++) freeChunks.push(i);
+  current = 0;
+  position = 0;
+  records = 0;
+  bytes = 0;
+  state = TraceState();
+
+  running = true;
+  writer = std::thread(&Tracer::run, this);
+  return true;
+}
+
+void Tracer::stop() {
+  if (output == nullptr) return;
+
+  if (position > 0) submitChunk();
+  running = false;
+  writer.join();
+
+  // the writer exits once it sees the queue empty after running was cleared, so every chunk is on disk
+  int chunk;
+  while (freeChunks.pop(chunk)) {}
+  fclose(output);
+  output = nullptr;
+}
+
+void Tracer::submitChunk() {
+  sizes[current] = position;
+  bytes += position;
+  while (!filledChunks.push(current)) std::this_thread::yield();
+  while (!freeChunks.pop(current)) std::this_thread::yield();
+  position = 0;
+}
+
+void Tracer::run() {
+  while (true) {
+    bool stopping = !running;
+    int chunk;
+    bool any = false;
+    while (filledChunks.pop(chunk)) {
+      fwrite(chunks + (size_t)chunk * TRACE_CHUNK_SIZE, 1, sizes[chunk], output);
+      while (!freeChunks.push(chunk)) std::this_thread::yield();
+      any = true;
+    }
+    if (stopping) break;
+    if (!any) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  fflush(output);
+}
+
+TraceReader::TraceReader() {
+  input = nullptr;
+}
+
+TraceReader::~TraceReader() {
+  if (input != nullptr) fclose(input);
+}
+
+bool TraceReader::open(std::string file) {
+  input = fopen(file.c_str(), "rb");
+  if (input == nullptr) return false;
+
+  char magic[sizeof(TRACE_MAGIC) - 1];
+  if (fread(magic, 1, sizeof(magic), input) != sizeof(magic) || memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+    fclose(input);
+    input = nullptr;
+    return false;
+  }
+  state = TraceState();
+  return true;
+}
+
+bool TraceReader::readByte(unsigned char& b) {
+  int c = fgetc(input);
+  if (c == EOF) return false;
+  b = c;
+  return true;
+}
+
+bool TraceReader::readVarint(unsigned int& value) {
+  value = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    unsigned char b;
+    if (!readByte(b)) return false;
+    value |= (unsigned int)(b & 0x7f) << shift;
+    if ((b & 0x80) == 0) return true;
+  }
+  return false;
+}
+
+bool TraceReader::next(TraceRecord& record) {
+  unsigned char flags;
+  if (input == nullptr || !readByte(flags)) return false;
+  record.flags = flags & (TRACE_REGISTER | TRACE_LOAD | TRACE_STORE);
+
+  unsigned int value;
+  if (flags & TRACE_SEQUENTIAL) {
+    record.pc = state.pc + 4;
+  } else {
+    if (!readVarint(value)) return false;
+    record.pc = state.pc + 4 + unzigzag(value);
+  }
+  state.pc = record.pc;
+
+  unsigned int line = (record.pc >> 2) & (TRACE_WORD_CACHE_SIZE - 1);
+  if (flags & TRACE_CACHED_WORD) {
+    record.word = state.cachedWords[line];
+  } else {
+    if (fread(&record.word, 1, sizeof(record.word), input) != sizeof(record.word)) return false;
+    state.cachedPcs[line] = record.pc;
+    state.cachedWords[line] = record.word;
+  }
+
+  if (record.flags & TRACE_REGISTER) {
+    if (!readByte(record.reg) || record.reg >= TRACE_REGISTERS_NUM || !readVarint(value)) return false;
+    record.value = state.registers[record.reg] + unzigzag(value);
+    state.registers[record.reg] = record.value;
+  }
+  if (record.flags & (TRACE_LOAD | TRACE_STORE)) {
+    if (!readVarint(value)) return false;
+    record.address = state.address + unzigzag(value);
+    state.address = record.address;
+    if (!readVarint(value)) return false;
+    record.data = unzigzag(value);
+  }
+  return true;
+}
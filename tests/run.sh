@@ -0,0 +1,111 @@
+#!/bin/sh
+# Differential check of the JIT against the interpreter. Assembles and links the tests/ program and
+# every guest kernel in bench/, then runs each with --jit-verify, once with the default JIT threshold
+# and once with threshold 0 so that every block that can be compiled is. Fails on any mismatch.
+# Also stops each kernel twice through snapshots, the second save over the restored file, and checks
+# that the resumed run ends like an uninterrupted one.
+# Run from the repository root after building asembler, linker and emulator, "make check" does both.
+
+KERNELS="arith memcpy recursive interrupts literals"
+BUILD=tests/build
+
+mkdir -p $BUILD
+
+# assemble NAME SOURCE: assembles SOURCE into $BUILD/NAME.o
+assemble() {
+  rm -f $BUILD/$1.o
+  ./asembler -o $BUILD/$1.o $2 > /dev/null
+  if [ ! -f $BUILD/$1.o ]; then echo "could not assemble $2"; exit 1; fi
+}
+
+# link NAME OPTIONS OBJECTS: links into $BUILD/NAME.lnk
+link() {
+  name=$1
+  options=$2
+  shift 2
+  rm -f $BUILD/$name.lnk
+  ./linker -hex $options -o $BUILD/$name.hex "$@" > /dev/null
+  if [ ! -f $BUILD/$name.lnk ]; then echo "could not link $name"; exit 1; fi
+}
+
+PROGRAMS="program"
+objects=""
+for source in main math handler isr_timer isr_terminal isr_software; do
+  assemble $source tests/$source.s
+  objects="$objects $BUILD/$source.o"
+done
+link program "-place=my_code@0x40000000 -place=my_handler@0x40001000" $objects
+
+for kernel in $KERNELS; do
+  assemble $kernel bench/$kernel.s
+  link $kernel "-place=code@0x40000000" $BUILD/$kernel.o
+  PROGRAMS="$PROGRAMS $kernel"
+done
+
+failed=0
+for program in $PROGRAMS; do
+  for threshold in default 0; do
+    flags="--jit-verify"
+    if [ $threshold != default ]; then flags="$flags --jit-threshold=$threshold"; fi
+    # the emulator leaves mem_content.hex in the working directory
+    output=$BUILD/$program.threshold-$threshold.txt
+    (cd $BUILD && ../../emulator $program.lnk $flags < /dev/null > ../../$output)
+
+    if grep -q "^JIT verification passed" $output; then
+      printf "%-12s threshold %-8s passed\n" $program $threshold
+    else
+      printf "%-12s threshold %-8s FAILED\n" $program $threshold
+      cat $output
+      failed=1
+    fi
+  done
+done
+
+if [ $failed -ne 0 ]; then
+  echo "JIT differs from the interpreter"
+  exit 1
+fi
+echo "JIT matches the interpreter on every program"
+
+# emulate NAME ARGUMENTS: runs the emulator in $BUILD, output in NAME.txt and memory in NAME.mem
+emulate() {
+  name=$1
+  shift
+  (cd $BUILD && ../../emulator "$@" < /dev/null > $name.txt && status=0 || status=$?
+   mv mem_content.hex $name.mem 2> /dev/null; exit $status)
+}
+
+# registers and memory at the end of a run, the snapshot runs have no map to annotate them with
+final_state() {
+  grep "^r[0-9]*=" $BUILD/$1.txt
+  cat $BUILD/$1.mem
+}
+
+# a run stopped by the instruction limit exits with 2
+for kernel in $KERNELS; do
+  snapshot=$kernel.snapshot
+  rm -f $BUILD/$snapshot
+  emulate $kernel.full $kernel.lnk
+  full=$?
+  emulate $kernel.save $kernel.lnk --max-instructions=1000 --save-snapshot=$snapshot
+  save=$?
+  emulate $kernel.resave --restore=$snapshot --max-instructions=1000 --save-snapshot=$snapshot
+  resave=$?
+  emulate $kernel.resumed --restore=$snapshot
+  resumed=$?
+
+  if [ $full -eq 0 ] && [ $save -eq 2 ] && [ $resave -eq 2 ] && [ $resumed -eq 0 ] &&
+     grep -q "^saved snapshot" $BUILD/$kernel.resave.txt &&
+     [ "$(final_state $kernel.resumed)" = "$(final_state $kernel.full)" ]; then
+    printf "%-12s snapshot           passed\n" $kernel
+  else
+    printf "%-12s snapshot           FAILED (exit %d %d %d %d)\n" $kernel $full $save $resave $resumed
+    failed=1
+  fi
+done
+
+if [ $failed -ne 0 ]; then
+  echo "a run resumed from snapshots differs from an uninterrupted one"
+  exit 1
+fi
+echo "snapshots resume every kernel"